@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace PGS
+{
+
+// Tag for buffers whose every element is written right after construction, so zero-filling them is wasted work
+struct UninitializedTag { explicit UninitializedTag() = default; };
+inline constexpr UninitializedTag Uninitialized{};
+
+// Process-wide cache of buffer storage, bucketed by exact byte size.
+// Re-evaluating a graph allocates the same few sizes over and over (one per buffer type at the canvas size),
+// so released blocks are handed to the next buffer of that size instead of going back to malloc.
+class BufferPool
+{
+public:
+    // Owning handle to a block of uninitialized memory; the destructor returns it to the pool
+    class Block
+    {
+        friend class BufferPool;
+
+        std::unique_ptr<std::byte[]> m_memory;
+        size_t m_size = 0;
+
+        Block(std::unique_ptr<std::byte[]> memory, size_t size);
+
+    public:
+        Block() = default;
+        ~Block();
+
+        Block(Block&& other) noexcept = default;
+        Block& operator=(Block&& other) noexcept;
+
+        Block(const Block&) = delete;
+        Block& operator=(const Block&) = delete;
+
+        [[nodiscard]] std::byte* data() const { return m_memory.get(); }
+        [[nodiscard]] size_t size() const { return m_size; }
+    };
+
+    struct Stats
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t cachedBytes = 0;
+    };
+
+    // @brief The shared pool. It is never destroyed, so buffers may outlive static destruction.
+    static BufferPool& instance();
+
+    // @brief Returns a block of `size` bytes. The contents are unspecified.
+    [[nodiscard]] Block acquire(size_t size);
+
+    // @brief Frees every cached block.
+    void trim();
+
+    void setMaxCachedBytes(size_t maxCachedBytes);
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    static constexpr size_t DEFAULT_MAX_CACHED_BYTES = 256 * 1024 * 1024;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<size_t, std::vector<std::unique_ptr<std::byte[]>>> m_freeBlocks;
+
+    size_t m_maxCachedBytes = DEFAULT_MAX_CACHED_BYTES;
+    Stats m_stats;
+
+    BufferPool() = default;
+
+    void release(std::unique_ptr<std::byte[]> memory, size_t size);
+};
+
+} // namespace PGS
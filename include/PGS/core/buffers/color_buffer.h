@@ -0,0 +1,46 @@
+#pragma once
+
+#include "PGS/core/buffers/buffer_pool.h"
+#include "PGS/core/buffers/float_color.h"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <span>
+
+namespace PGS
+{
+
+// Color buffer used between nodes. Channels are not clamped or quantized here:
+// that happens once, when the final output is converted to a PixelBuffer.
+class ColorBuffer
+{
+private:
+    sf::Vector2u m_size;
+    BufferPool::Block m_storage;
+    FloatColor* m_colors; // Points into m_storage
+
+public:
+    // --- Constructors | Destructor ---
+    explicit ColorBuffer(const sf::Vector2u& size);
+    // @brief Leaves the colors unspecified, for callers that overwrite all of them.
+    ColorBuffer(const sf::Vector2u& size, UninitializedTag);
+    ~ColorBuffer() = default;
+
+    // --- Methods ---
+    void setColor(const sf::Vector2u& pos, const FloatColor& color);
+    [[nodiscard]] FloatColor getColor(const sf::Vector2u& pos) const;
+
+    void clear(const FloatColor& color = FloatColor::White);
+
+    // Direct access for tight loops: no index computation or bounds check per color
+    [[nodiscard]] std::span<FloatColor> getRow(unsigned int y);
+    [[nodiscard]] std::span<const FloatColor> getRow(unsigned int y) const;
+    // @brief All colors, row after row.
+    [[nodiscard]] std::span<FloatColor> getColors();
+    [[nodiscard]] std::span<const FloatColor> getColors() const;
+
+    [[nodiscard]] sf::Vector2u getSize() const;
+    [[nodiscard]] const FloatColor* getData() const;
+};
+
+} // namespace PGS
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace PGS
+{
+
+// RGBA color with float32 channels, nominally in [0, 1]
+struct FloatColor
+{
+    float r = 0.0f;
+    float g = 0.0f;
+    float b = 0.0f;
+    float a = 1.0f;
+
+    static const FloatColor Black;
+    static const FloatColor White;
+    static const FloatColor Transparent;
+
+    bool operator==(const FloatColor& other) const = default;
+};
+
+inline constexpr FloatColor FloatColor::Black{0.0f, 0.0f, 0.0f, 1.0f};
+inline constexpr FloatColor FloatColor::White{1.0f, 1.0f, 1.0f, 1.0f};
+inline constexpr FloatColor FloatColor::Transparent{0.0f, 0.0f, 0.0f, 0.0f};
+
+} // namespace PGS
\ No newline at end of file
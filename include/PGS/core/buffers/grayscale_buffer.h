@@ -1,30 +1,43 @@
 #pragma once
 
+#include "PGS/core/buffers/buffer_pool.h"
+
 #include <SFML/System/Vector2.hpp>
 
-#include <vector>
-#include <cstdint>
+#include <span>
 
 namespace PGS
 {
 
+// Single-channel float32 buffer. Values are nominally in [0, 1] but are not clamped,
+// so chained nodes keep full precision until the final output is quantized.
 class GrayscaleBuffer
 {
 private:
     sf::Vector2u m_size;
-    std::vector<std::uint8_t> m_values{};
+    BufferPool::Block m_storage;
+    float* m_values; // Points into m_storage
 
 public:
     // --- Constructors | Destructor ---
     explicit GrayscaleBuffer(const sf::Vector2u& size);
+    // @brief Leaves the values unspecified, for callers that overwrite all of them.
+    GrayscaleBuffer(const sf::Vector2u& size, UninitializedTag);
     ~GrayscaleBuffer() = default;
 
     // --- Methods ---
-    void setValue(const sf::Vector2u& pos, uint8_t value);
-    [[nodiscard]] uint8_t getValue(const sf::Vector2u& pos) const;
+    void setValue(const sf::Vector2u& pos, float value);
+    [[nodiscard]] float getValue(const sf::Vector2u& pos) const;
+
+    // Direct access for tight loops: no index computation or bounds check per value
+    [[nodiscard]] std::span<float> getRow(unsigned int y);
+    [[nodiscard]] std::span<const float> getRow(unsigned int y) const;
+    // @brief All values, row after row.
+    [[nodiscard]] std::span<float> getValues();
+    [[nodiscard]] std::span<const float> getValues() const;
 
     [[nodiscard]] sf::Vector2u getSize() const;
-    [[nodiscard]] const uint8_t* getData() const;
+    [[nodiscard]] const float* getData() const;
 };
 
 } // namespace PGS
\ No newline at end of file
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "PGS/core/buffers/buffer_pool.h"
+
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Graphics/Color.hpp>
 
-#include <vector>
 #include <cstdint>
+#include <span>
 
 namespace PGS
 {
@@ -13,11 +15,14 @@ class PixelBuffer
 {
 private:
     sf::Vector2u m_size;
-    std::vector<std::uint8_t> m_pixels;
+    BufferPool::Block m_storage;
+    sf::Color* m_pixels; // Points into m_storage, row by row (r, g, b, a bytes per pixel)
 
 public:
 	// --- Constructors | Destructor ---
     explicit PixelBuffer(const sf::Vector2u& size);
+    // @brief Leaves the pixels unspecified, for callers that overwrite all of them.
+    PixelBuffer(const sf::Vector2u& size, UninitializedTag);
     ~PixelBuffer() = default;
 
     // --- Methods ---
@@ -26,6 +31,13 @@ public:
 
     void clear(const sf::Color& color = sf::Color::White);
 
+    // Direct access for tight loops: no index computation or bounds check per pixel
+    [[nodiscard]] std::span<sf::Color> getRow(unsigned int y);
+    [[nodiscard]] std::span<const sf::Color> getRow(unsigned int y) const;
+    // @brief All pixels, row after row.
+    [[nodiscard]] std::span<sf::Color> getPixels();
+    [[nodiscard]] std::span<const sf::Color> getPixels() const;
+
     [[nodiscard]] sf::Vector2u getSize() const;
     [[nodiscard]] const uint8_t* getData() const;
 };
@@ -1,29 +1,70 @@
 #pragma once
 
+#include "PGS/core/buffers/buffer_pool.h"
+
 #include <SFML/System/Vector2.hpp>
 
-#include <vector>
+#include <cstddef>
+#include <span>
+#include <type_traits>
 
 namespace PGS
 {
 
+// Vectors are stored as two planes (structure of arrays): all X components, then all Y components.
+// A SIMD kernel loads several lanes of one component from a row span instead of deinterleaving pairs.
+// Both planes start on a 32 byte boundary, so loads at vector indices that are a multiple of 8 are aligned.
+// There is no padding a load may read: the tail shorter than a full register is handled per vector.
 class VectorFieldBuffer
 {
+public:
+    // A run of vectors as two parallel component spans
+    template <typename T>
+    struct BasicSpan
+    {
+        std::span<T> x;
+        std::span<T> y;
+
+        [[nodiscard]] size_t size() const { return x.size(); }
+        [[nodiscard]] sf::Vector2f operator[](const size_t i) const { return {x[i], y[i]}; }
+
+        void set(const size_t i, const sf::Vector2f& vec) const requires (!std::is_const_v<T>)
+        {
+            x[i] = vec.x;
+            y[i] = vec.y;
+        }
+
+        operator BasicSpan<const T>() const requires (!std::is_const_v<T>) { return {x, y}; }
+    };
+
+    using Span = BasicSpan<float>;
+    using ConstSpan = BasicSpan<const float>;
+
 private:
     sf::Vector2u m_size;
-    std::vector<sf::Vector2f> m_vectors;
+    BufferPool::Block m_storage;
+    float* m_xs; // X plane, points into m_storage
+    float* m_ys; // Y plane, points into m_storage
 
 public:
     // --- Constructors | Destructor ---
     explicit VectorFieldBuffer(const sf::Vector2u& size);
+    // @brief Leaves the vectors unspecified, for callers that overwrite all of them.
+    VectorFieldBuffer(const sf::Vector2u& size, UninitializedTag);
     ~VectorFieldBuffer() = default;
 
     // --- Methods ---
     void setVector(const sf::Vector2u& pos, const sf::Vector2f& vec);
     [[nodiscard]] sf::Vector2f getVector(const sf::Vector2u& pos) const;
 
+    // Direct access for tight loops: no index computation or bounds check per vector
+    [[nodiscard]] Span getRow(unsigned int y);
+    [[nodiscard]] ConstSpan getRow(unsigned int y) const;
+    // @brief All vectors, row after row.
+    [[nodiscard]] Span getVectors();
+    [[nodiscard]] ConstSpan getVectors() const;
+
     [[nodiscard]] sf::Vector2u getSize() const;
-    [[nodiscard]] const sf::Vector2f* getData() const;
 };
 
 } // namespace PGS
\ No newline at end of file
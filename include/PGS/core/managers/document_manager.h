@@ -2,11 +2,13 @@
 
 #include "PGS/core/config.h"
 #include "PGS/gui/canvas.h"
+#include "PGS/node_graph/evaluation_service.h"
 
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/System/Time.hpp>
 
+#include <cstdint>
 #include <memory>
 
 namespace PGS
@@ -30,6 +32,13 @@ private:
     std::shared_ptr<PixelBuffer> m_pixelBuffer;
     Gui::Canvas m_canvasView;
 
+    // The graph is evaluated in the background; a new request is sent only when the graph or the size changed
+    // or a new document replaced the image (m_republishRequested)
+    NodeGraph::EvaluationService m_evaluationService;
+    std::uint64_t m_requestedRevision = 0;
+    sf::Vector2u m_requestedSize;
+    bool m_republishRequested = false;
+
     const float CANVAS_PADDING_FACTOR = 1.5f;
 
 public:
@@ -1,73 +1,149 @@
 #pragma once
 
+#include "PGS/core/buffers/color_buffer.h"
 #include "PGS/core/buffers/pixel_buffer.h"
 #include "PGS/core/buffers/grayscale_buffer.h"
 #include "PGS/core/buffers/vector_field_buffer.h"
 
 #include "PGS/node_graph/types.h"
+#include "PGS/node_graph/utils/simd.h"
 
 #include <cmath>
 #include <memory>
 #include <algorithm>
+#include <cstdint>
+#include <utility>
 
 namespace PGS::NodeGraph::Converters
 {
-    // @brief Converts PixelBuffer to GrayscaleBuffer.
-    inline std::shared_ptr<GrayscaleBuffer> toGrayscale(const std::shared_ptr<PixelBuffer>& pixelBuffer)
-    {
-        if (!pixelBuffer) return nullptr;
-        const auto size = pixelBuffer->getSize();
-        auto grayscaleBuffer = std::make_shared<GrayscaleBuffer>(size);
-
-        for (unsigned int y = 0; y < size.y; ++y) {
-            for (unsigned int x = 0; x < size.x; ++x) {
-                const sf::Color color = pixelBuffer->getPixel({x, y});
-
-                const float luminance = 0.299f * static_cast<float>(color.r) +
-                                        0.587f * static_cast<float>(color.g) +
-                                        0.114f * static_cast<float>(color.b);
-                grayscaleBuffer->setValue({x, y}, static_cast<uint8_t>(luminance));
-            }
+    // The buffer conversions below treat colors as interleaved RGBA floats and pixels as RGBA bytes
+    static_assert(sizeof(FloatColor) == 4 * sizeof(float));
+    static_assert(sizeof(sf::Color) == 4);
+
+    // @brief Luminance of a color as a grayscale value.
+    inline float toLuminance(const FloatColor& color)
+    {
+        return 0.299f * color.r + 0.587f * color.g + 0.114f * color.b;
+    }
+
+    // @brief Converts a number to a uniform gray color.
+    inline FloatColor toColor(const float value)
+    {
+        return {value, value, value, 1.0f};
+    }
+
+    // @brief Converts an 8-bit color (port values, the UI) to float channels.
+    inline FloatColor toFloatColor(const sf::Color& color)
+    {
+        return {
+            static_cast<float>(color.r) / 255.0f,
+            static_cast<float>(color.g) / 255.0f,
+            static_cast<float>(color.b) / 255.0f,
+            static_cast<float>(color.a) / 255.0f
+        };
+    }
+
+    // @brief Quantizes a channel to 8 bits, rounding to nearest. Out of range values (and NaN) are clamped.
+    inline uint8_t toByte(const float value)
+    {
+        const float clamped = std::min(std::max(0.0f, value), 1.0f);
+        return static_cast<uint8_t>(clamped * 255.0f + 0.5f);
+    }
+
+    // @brief Quantizes a color to 8 bits per channel.
+    inline sf::Color toRgba8(const FloatColor& color)
+    {
+        return {toByte(color.r), toByte(color.g), toByte(color.b), toByte(color.a)};
+    }
+
+    // --- Between node data types ---
+
+    // @brief Converts ColorBuffer to GrayscaleBuffer.
+    inline std::shared_ptr<GrayscaleBuffer> toGrayscale(const std::shared_ptr<ColorBuffer>& colorBuffer)
+    {
+        if (!colorBuffer) return nullptr;
+        const auto size = colorBuffer->getSize();
+        auto grayscaleBuffer = std::make_shared<GrayscaleBuffer>(size, Uninitialized);
+
+        const auto colors = std::as_const(*colorBuffer).getColors();
+        const auto values = grayscaleBuffer->getValues();
+        const auto* channels = reinterpret_cast<const float*>(colors.data());
+
+        // Same weights and order of operations as toLuminance, so the values are identical
+        using namespace Utils::Simd;
+        const Float4 weightR = set1(0.299f), weightG = set1(0.587f), weightB = set1(0.114f);
+
+        size_t i = 0;
+        for (; i + LANES <= values.size(); i += LANES)
+        {
+            Float4 r, g, b, a;
+            loadInterleaved(channels + i * 4, r, g, b, a);
+            store(values.data() + i, add(add(mul(weightR, r), mul(weightG, g)), mul(weightB, b)));
         }
+        for (; i < values.size(); ++i)
+            values[i] = toLuminance(colors[i]);
+
         return grayscaleBuffer;
     }
 
     // @brief Creates a GrayscaleBuffer of the specified size (`size`), filled with one value (`value`).
     inline std::shared_ptr<GrayscaleBuffer> toGrayscale(const float value, const sf::Vector2u& size)
     {
-        auto grayscaleBuffer = std::make_shared<GrayscaleBuffer>(size);
-        const uint8_t byteValue = static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f);
+        auto grayscaleBuffer = std::make_shared<GrayscaleBuffer>(size, Uninitialized);
+        std::ranges::fill(grayscaleBuffer->getValues(), value);
+
+        return grayscaleBuffer;
+    }
 
-        auto* dataPtr = const_cast<uint8_t*>(grayscaleBuffer->getData());
-        std::fill_n(dataPtr, (size.x * size.y), byteValue);
+    // @brief Creates a GrayscaleBuffer of the specified size (`size`), filled with the luminance of `color`.
+    inline std::shared_ptr<GrayscaleBuffer> toGrayscale(const FloatColor& color, const sf::Vector2u& size)
+    {
+        auto grayscaleBuffer = std::make_shared<GrayscaleBuffer>(size, Uninitialized);
+        std::ranges::fill(grayscaleBuffer->getValues(), toLuminance(color));
 
         return grayscaleBuffer;
     }
 
-    // @brief Converts GrayscaleBuffer to PixelBuffer.
-    inline std::shared_ptr<PixelBuffer> toPixel(const std::shared_ptr<GrayscaleBuffer>& grayscaleBuffer)
+    // @brief Converts GrayscaleBuffer to ColorBuffer.
+    inline std::shared_ptr<ColorBuffer> toColorBuffer(const std::shared_ptr<GrayscaleBuffer>& grayscaleBuffer)
     {
         if (!grayscaleBuffer) return nullptr;
         const auto size = grayscaleBuffer->getSize();
-        auto pixelBuffer = std::make_shared<PixelBuffer>(size);
+        auto colorBuffer = std::make_shared<ColorBuffer>(size, Uninitialized);
+
+        const auto values = std::as_const(*grayscaleBuffer).getValues();
+        const auto colors = colorBuffer->getColors();
+        auto* channels = reinterpret_cast<float*>(colors.data());
 
-        for (unsigned int y = 0; y < size.y; ++y) {
-            for (unsigned int x = 0; x < size.x; ++x) {
-                const uint8_t value = grayscaleBuffer->getValue({x, y});
+        using namespace Utils::Simd;
+        const Float4 opaque = set1(1.0f);
 
-                pixelBuffer->setPixel({x, y}, sf::Color(value, value, value));
-            }
+        size_t i = 0;
+        for (; i + LANES <= values.size(); i += LANES)
+        {
+            const Float4 gray = load(values.data() + i);
+            storeInterleaved(channels + i * 4, gray, gray, gray, opaque);
         }
-        return pixelBuffer;
+        for (; i < values.size(); ++i)
+            colors[i] = toColor(values[i]);
+
+        return colorBuffer;
     }
 
-    // @brief Creates a PixelBuffer of the specified size (`size`), filled with one color (`value`).
-    inline std::shared_ptr<PixelBuffer> toPixel(const float value, const sf::Vector2u& size)
+    // @brief Creates a ColorBuffer of the specified size (`size`), filled with one gray value (`value`).
+    inline std::shared_ptr<ColorBuffer> toColorBuffer(const float value, const sf::Vector2u& size)
     {
-        auto pixelBuffer = std::make_shared<PixelBuffer>(size);
-        const uint8_t byteValue = static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f);
-        pixelBuffer->clear(sf::Color(byteValue, byteValue, byteValue));
-        return pixelBuffer;
+        auto colorBuffer = std::make_shared<ColorBuffer>(size, Uninitialized);
+        colorBuffer->clear(toColor(value));
+        return colorBuffer;
+    }
+
+    // @brief Creates a ColorBuffer of the specified size (`size`), filled with one color (`color`).
+    inline std::shared_ptr<ColorBuffer> toColorBuffer(const FloatColor& color, const sf::Vector2u& size)
+    {
+        auto colorBuffer = std::make_shared<ColorBuffer>(size, Uninitialized);
+        colorBuffer->clear(color);
+        return colorBuffer;
     }
 
     // @brief Converts GrayscaleBuffer to VectorFieldBuffer.
@@ -75,34 +151,57 @@ namespace PGS::NodeGraph::Converters
     {
         if (!grayscaleBuffer) return nullptr;
         const auto size = grayscaleBuffer->getSize();
-        auto vectorField = std::make_shared<VectorFieldBuffer>(size);
+        auto vectorField = std::make_shared<VectorFieldBuffer>(size, Uninitialized);
+
+        const auto values = std::as_const(*grayscaleBuffer).getValues();
+        const auto vectors = vectorField->getVectors();
+        std::ranges::fill(vectors.x, 0.f);
+        std::transform(values.begin(), values.end(), vectors.y.begin(),
+            [](const float value) { return -value; });
 
-        for (unsigned int y = 0; y < size.y; ++y) {
-            for (unsigned int x = 0; x < size.x; ++x) {
-                const float value = static_cast<float>(grayscaleBuffer->getValue({x, y})) / 255.f;
-                vectorField->setVector({x, y}, {0.f, -value});
-            }
-        }
         return vectorField;
     }
 
-    // @brief Converts PixelBuffer to VectorFieldBuffer.
-    inline std::shared_ptr<VectorFieldBuffer> toVectorField(const std::shared_ptr<PixelBuffer>& pixelBuffer)
+    // @brief Converts ColorBuffer to VectorFieldBuffer.
+    inline std::shared_ptr<VectorFieldBuffer> toVectorField(const std::shared_ptr<ColorBuffer>& colorBuffer)
     {
-        if (!pixelBuffer) return nullptr;
-        const auto size = pixelBuffer->getSize();
-        auto vectorField = std::make_shared<VectorFieldBuffer>(size);
+        if (!colorBuffer) return nullptr;
+        const auto size = colorBuffer->getSize();
+        auto vectorField = std::make_shared<VectorFieldBuffer>(size, Uninitialized);
+
+        // [0, 1] -> [-1, 1]
+        const auto colors = std::as_const(*colorBuffer).getColors();
+        const auto vectors = vectorField->getVectors();
+        const auto* channels = reinterpret_cast<const float*>(colors.data());
+
+        using namespace Utils::Simd;
+        const Float4 two = set1(2.0f), one = set1(1.0f);
+
+        size_t i = 0;
+        for (; i + LANES <= colors.size(); i += LANES)
+        {
+            Float4 r, g, b, a;
+            loadInterleaved(channels + i * 4, r, g, b, a);
+            store(vectors.x.data() + i, sub(mul(r, two), one));
+            store(vectors.y.data() + i, sub(mul(g, two), one));
+        }
+        for (; i < colors.size(); ++i)
+            vectors.set(i, {colors[i].r * 2.0f - 1.0f, colors[i].g * 2.0f - 1.0f});
+
+        return vectorField;
+    }
 
-        for (unsigned int y = 0; y < size.y; ++y) {
-            for (unsigned int x = 0; x < size.x; ++x) {
-                const sf::Color color = pixelBuffer->getPixel({x, y});
+    // @brief Creates a VectorFieldBuffer of the specified size (`size`), filled with the vector encoded in `color`.
+    inline std::shared_ptr<VectorFieldBuffer> toVectorField(const FloatColor& color, const sf::Vector2u& size)
+    {
+        auto vectorField = std::make_shared<VectorFieldBuffer>(size, Uninitialized);
 
-                const float vecX = (static_cast<float>(color.r) / 127.5f) - 1.0f; // [0, 255] -> [-1, 1]
-                const float vecY = (static_cast<float>(color.g) / 127.5f) - 1.0f; // [0, 255] -> [-1, 1]
+        const float vecX = color.r * 2.0f - 1.0f; // [0, 1] -> [-1, 1]
+        const float vecY = color.g * 2.0f - 1.0f; // [0, 1] -> [-1, 1]
 
-                vectorField->setVector({x, y}, {vecX, vecY});
-            }
-        }
+        const auto vectors = vectorField->getVectors();
+        std::ranges::fill(vectors.x, vecX);
+        std::ranges::fill(vectors.y, vecY);
         return vectorField;
     }
 
@@ -112,24 +211,120 @@ namespace PGS::NodeGraph::Converters
         if (!grayscaleBuffer || (grayscaleBuffer->getSize().x * grayscaleBuffer->getSize().y == 0)) {
             return 0.0f;
         }
-        unsigned long long sum = 0;
         const auto size = grayscaleBuffer->getSize();
         const auto* data = grayscaleBuffer->getData();
         const size_t totalPixels = size.x * size.y;
 
-        for (size_t i = 0; i < totalPixels; ++i) {
+        // Short runs are summed in float lanes, which stay exact enough, and the partial sums in double
+        using namespace Utils::Simd;
+        constexpr size_t RUN_LENGTH = 64;
+
+        double sum = 0.0;
+        size_t i = 0;
+        for (; i + RUN_LENGTH <= totalPixels; i += RUN_LENGTH)
+        {
+            Float4 partial = load(data + i);
+            for (size_t j = LANES; j < RUN_LENGTH; j += LANES)
+                partial = add(partial, load(data + i + j));
+
+            float lanes[LANES];
+            store(lanes, partial);
+            for (const float lane : lanes)
+                sum += lane;
+        }
+        for (; i < totalPixels; ++i)
             sum += data[i];
+
+        return static_cast<float>(sum / static_cast<double>(totalPixels));
+    }
+
+    // --- To the final 8-bit output ---
+
+    // @brief Quantizes ColorBuffer to an RGBA8 PixelBuffer.
+    inline std::shared_ptr<PixelBuffer> toPixel(const std::shared_ptr<ColorBuffer>& colorBuffer)
+    {
+        if (!colorBuffer) return nullptr;
+        const auto size = colorBuffer->getSize();
+        auto pixelBuffer = std::make_shared<PixelBuffer>(size, Uninitialized);
+
+        const auto colors = std::as_const(*colorBuffer).getColors();
+        const auto pixels = pixelBuffer->getPixels();
+        const auto* channels = reinterpret_cast<const float*>(colors.data());
+        auto* bytes = reinterpret_cast<std::uint8_t*>(pixels.data());
+
+        // Same operations as toByte, 4 pixels (16 channels) at a time
+        using namespace Utils::Simd;
+        const Float4 scale = set1(255.0f), half = set1(0.5f);
+        const auto quantize = [&](const float* source) { return add(mul(clamp01(load(source)), scale), half); };
+
+        size_t i = 0;
+        for (; i + LANES <= colors.size(); i += LANES)
+        {
+            const float* source = channels + i * 4;
+            storeBytes(bytes + i * 4, quantize(source), quantize(source + 4), quantize(source + 8), quantize(source + 12));
         }
+        for (; i < colors.size(); ++i)
+            pixels[i] = toRgba8(colors[i]);
 
-        return static_cast<float>(sum) / static_cast<float>(totalPixels) / 255.f;
+        return pixelBuffer;
+    }
+
+    // @brief Quantizes GrayscaleBuffer to an opaque gray RGBA8 PixelBuffer.
+    inline std::shared_ptr<PixelBuffer> toPixel(const std::shared_ptr<GrayscaleBuffer>& grayscaleBuffer)
+    {
+        if (!grayscaleBuffer) return nullptr;
+        const auto size = grayscaleBuffer->getSize();
+        auto pixelBuffer = std::make_shared<PixelBuffer>(size, Uninitialized);
+
+        const auto values = std::as_const(*grayscaleBuffer).getValues();
+        const auto pixels = pixelBuffer->getPixels();
+        auto* bytes = reinterpret_cast<std::uint8_t*>(pixels.data());
+
+        using namespace Utils::Simd;
+        const Float4 scale = set1(255.0f), half = set1(0.5f), opaque = set1(255.0f);
+
+        size_t i = 0;
+        for (; i + LANES <= values.size(); i += LANES)
+        {
+            const Float4 gray = add(mul(clamp01(load(values.data() + i)), scale), half);
+
+            float channels[LANES * 4];
+            storeInterleaved(channels, gray, gray, gray, opaque);
+            storeBytes(bytes + i * 4, load(channels), load(channels + 4), load(channels + 8), load(channels + 12));
+        }
+        for (; i < values.size(); ++i)
+        {
+            const uint8_t byteValue = toByte(values[i]);
+            pixels[i] = sf::Color(byteValue, byteValue, byteValue);
+        }
+
+        return pixelBuffer;
+    }
+
+    // @brief Creates a PixelBuffer of the specified size (`size`), filled with one gray value (`value`).
+    inline std::shared_ptr<PixelBuffer> toPixel(const float value, const sf::Vector2u& size)
+    {
+        auto pixelBuffer = std::make_shared<PixelBuffer>(size, Uninitialized);
+        pixelBuffer->clear(toRgba8(toColor(value)));
+        return pixelBuffer;
+    }
+
+    // @brief Creates a PixelBuffer of the specified size (`size`), filled with one color (`color`).
+    inline std::shared_ptr<PixelBuffer> toPixel(const FloatColor& color, const sf::Vector2u& size)
+    {
+        auto pixelBuffer = std::make_shared<PixelBuffer>(size, Uninitialized);
+        pixelBuffer->clear(toRgba8(color));
+        return pixelBuffer;
     }
 
-    inline HSV rgbToHsv(const sf::Color& rgb) {
+    // --- HSV ---
+
+    inline HSV rgbToHsv(const FloatColor& rgb) {
         HSV hsv{};
 
-        float r = static_cast<float>(rgb.r) / 255.0f;
-        float g = static_cast<float>(rgb.g) / 255.0f;
-        float b = static_cast<float>(rgb.b) / 255.0f;
+        const float r = rgb.r;
+        const float g = rgb.g;
+        const float b = rgb.b;
 
         const float cMax = std::max({r, g, b});
         const float cMin = std::min({r, g, b});
@@ -158,7 +353,8 @@ namespace PGS::NodeGraph::Converters
     }
 
 
-    inline sf::Color hsvToRgb(const HSV& hsv ) {
+    // @brief The alpha of the result is 1.
+    inline FloatColor hsvToRgb(const HSV& hsv ) {
         float r = 0, g = 0, b = 0;
         const float h = hsv.h, s = hsv.s, v = hsv.v;
 
@@ -178,11 +374,68 @@ namespace PGS::NodeGraph::Converters
             default: r = g = b = 0; break;
         }
 
-        return {
-            static_cast<uint8_t>(std::clamp(r, 0.0f, 1.0f) * 255.0f),
-            static_cast<uint8_t>(std::clamp(g, 0.0f, 1.0f) * 255.0f),
-            static_cast<uint8_t>(std::clamp(b, 0.0f, 1.0f) * 255.0f)
-        };
+        return {r, g, b, 1.0f};
+    }
+
+    // --- HSV, 4 colors at once ---
+
+    // One register per component, each lane is a separate color
+    struct HSVLanes
+    {
+        Utils::Simd::Float4 h, s, v;
+    };
+
+    // @brief Same results as rgbToHsv, without branches. The fmod is left out: for a hue computed
+    //        from the red sector it never changes the value, (g - b) / delta is within [-1, 1].
+    inline HSVLanes rgbToHsv(const Utils::Simd::Float4 r, const Utils::Simd::Float4 g, const Utils::Simd::Float4 b)
+    {
+        using namespace Utils::Simd;
+
+        const Float4 zero = set1(0.0f);
+
+        const Float4 cMax = max(max(r, g), b);
+        const Float4 cMin = min(min(r, g), b);
+        const Float4 delta = sub(cMax, cMin);
+
+        // Every sector is computed, the unused ones (and divisions by zero) are discarded
+        const Float4 hueR = div(sub(g, b), delta);
+        const Float4 hueG = add(div(sub(b, r), delta), set1(2.0f));
+        const Float4 hueB = add(div(sub(r, g), delta), set1(4.0f));
+
+        Float4 h = select(equal(cMax, r), hueR, select(equal(cMax, g), hueG, hueB));
+        h = select(equal(delta, zero), zero, h);
+        h = div(h, set1(6.0f));
+        h = select(lessThan(h, zero), add(h, set1(1.0f)), h);
+
+        const Float4 s = select(equal(cMax, zero), zero, div(delta, cMax));
+
+        return {h, s, cMax};
+    }
+
+    // @brief Same results as hsvToRgb, without branches.
+    inline void hsvToRgb(const HSVLanes& hsv, Utils::Simd::Float4& r, Utils::Simd::Float4& g, Utils::Simd::Float4& b)
+    {
+        using namespace Utils::Simd;
+
+        const Float4 one = set1(1.0f);
+        const Float4 scaled = mul(hsv.h, set1(6.0f));
+        const Float4 i = trunc(scaled);
+
+        const Float4 f = sub(scaled, i);
+        const Float4 p = mul(hsv.v, sub(one, hsv.s));
+        const Float4 q = mul(hsv.v, sub(one, mul(f, hsv.s)));
+        const Float4 t = mul(hsv.v, sub(one, mul(sub(one, f), hsv.s)));
+
+        // i % 6 for the hue range [0, 1]; any other sector (a NaN hue) is black, like the default case
+        const Float4 sector = select(equal(i, set1(6.0f)), set1(0.0f), i);
+        const auto isSector = [&](const float index) { return equal(sector, set1(index)); };
+
+        const Mask4 s0 = isSector(0), s1 = isSector(1), s2 = isSector(2), s3 = isSector(3), s4 = isSector(4), s5 = isSector(5);
+        const Float4 black = set1(0.0f);
+
+        r = select(s0, hsv.v, select(s1, q, select(s2, p, select(s3, p, select(s4, t, select(s5, hsv.v, black))))));
+        g = select(s0, t, select(s1, hsv.v, select(s2, hsv.v, select(s3, q, select(s4, p, select(s5, p, black))))));
+        b = select(s0, p, select(s1, p, select(s2, t, select(s3, hsv.v, select(s4, hsv.v, select(s5, q, black))))));
     }
 
 } // namespace PGS::NodeGraph::Converters
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "PGS/node_graph/port_id.h"
+#include "PGS/node_graph/utils/thread_pool.h"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+
+namespace PGS
+{
+    class VectorFieldBuffer;
+}
+
+namespace PGS::NodeGraph
+{
+
+// Thrown by the evaluator when the stop token of a running evaluation was triggered
+class EvaluationCancelled : public std::runtime_error
+{
+public:
+    EvaluationCancelled() : std::runtime_error("Evaluation was cancelled") {}
+};
+
+// Everything a node needs to know about the current evaluation besides its inputs.
+struct EvaluationContext
+{
+    sf::Vector2u bufferSize;
+
+    // Default coordinates (x / width, y / height) of every pixel, built once per buffer size.
+    // Shared by all nodes: read it or pass it on as an output, never write to it.
+    std::shared_ptr<VectorFieldBuffer> uvField;
+
+    // Outputs of the calculated node whose results are used, empty means all of them.
+    // Nodes may leave the others out of their results.
+    std::span<const PortID> demandedOutputs;
+
+    // nullptr means single-threaded evaluation
+    Utils::ThreadPool* threadPool = nullptr;
+
+    // Requested when the result is no longer needed; kernels stop early and the evaluator discards the result
+    std::stop_token stopToken;
+
+    [[nodiscard]] bool isCancelled() const
+    {
+        return stopToken.stop_requested();
+    }
+
+    [[nodiscard]] bool isOutputDemanded(const PortID& portId) const
+    {
+        return demandedOutputs.empty() || std::ranges::find(demandedOutputs, portId) != demandedOutputs.end();
+    }
+
+    // @brief Splits the rows of the output buffer into bands and calls `function(rowBegin, rowEnd)`
+    //        for each of them, in parallel when a thread pool is available.
+    //        Bands never overlap, so writing to the rows of the own band needs no synchronization.
+    void forEachRowBand(const std::function<void(unsigned int, unsigned int)>& function) const
+    {
+        if (!threadPool || threadPool->getThreadCount() == 1)
+        {
+            function(0, bufferSize.y);
+            return;
+        }
+
+        // Keep a band at least a few thousand pixels large so small buffers aren't split into tiny tasks
+        constexpr unsigned int MIN_PIXELS_PER_BAND = 4096;
+        const size_t grainSize = std::max(1u, MIN_PIXELS_PER_BAND / std::max(bufferSize.x, 1u));
+
+        threadPool->parallelFor(0, bufferSize.y, grainSize, [&](const size_t rowBegin, const size_t rowEnd)
+        {
+            if (isCancelled())
+                return;
+
+            function(static_cast<unsigned int>(rowBegin), static_cast<unsigned int>(rowEnd));
+        });
+    }
+};
+
+} // namespace PGS::NodeGraph
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "PGS/node_graph/evaluator.h"
+#include "PGS/node_graph/graph_snapshot.h"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+namespace PGS
+{
+    class PixelBuffer;
+}
+
+namespace PGS::NodeGraph
+{
+
+// Evaluates graph snapshots on a background thread.
+// The worker owns its own Evaluator, so caches of unchanged nodes survive between requests.
+// A new request cancels the one still running: only the newest result is ever published.
+class EvaluationService
+{
+private:
+    struct Job
+    {
+        GraphSnapshot snapshot;
+        sf::Vector2u bufferSize;
+        std::stop_token stopToken;
+    };
+
+    Evaluator m_evaluator; // Accessed by the worker only
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+
+    std::optional<Job> m_pendingJob;
+    std::stop_source m_currentJobStop;
+
+    std::shared_ptr<PixelBuffer> m_result;
+    std::uint64_t m_publishedGeneration = 0; // Output generation of the last published result, 0 for none
+    std::exception_ptr m_error;
+
+    std::jthread m_worker; // Declared last: the worker has to stop before the rest is destroyed
+
+    void workerLoop(const std::stop_token& stopToken);
+
+public:
+    EvaluationService();
+    ~EvaluationService();
+
+    // Non-copyable
+    EvaluationService(const EvaluationService&) = delete;
+    EvaluationService& operator=(const EvaluationService&) = delete;
+
+    // @brief Queues `snapshot` for evaluation, replacing the queued request and cancelling the running one.
+    //        With `republish` the next result is published even if it is the output published last,
+    //        for callers that dropped the image they took before (e.g. a new document of the same size).
+    void request(GraphSnapshot snapshot, sf::Vector2u bufferSize, bool republish = false);
+
+    // @brief Returns the newest finished image once, nullptr while nothing new is available.
+    //        Evaluations that end up with the same output as before publish nothing.
+    //        Rethrows errors of the evaluation other than cancellation.
+    std::shared_ptr<PixelBuffer> takeResult();
+};
+
+} // namespace PGS::NodeGraph
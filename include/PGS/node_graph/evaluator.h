@@ -3,23 +3,37 @@
 #include "PGS/node_graph/types.h"
 
 #include "PGS/node_graph/node.h"
+#include "PGS/node_graph/graph_snapshot.h"
+#include "PGS/node_graph/result_cache.h"
 #include "PGS/node_graph/nodes/texture_output_node.h"
+#include "PGS/node_graph/utils/thread_pool.h"
 
 #include <SFML/System/Vector2.hpp>
 
+#include <cstdint>
+#include <stop_token>
 #include <utility>
 #include <vector>
 #include <memory>
 #include <typeindex>
 #include <unordered_map>
 #include <map>
+#include <optional>
 #include <functional>
+#include <span>
 #include <string>
 
+namespace PGS
+{
+    class PixelBuffer;
+    class VectorFieldBuffer;
+}
+
 namespace PGS::NodeGraph
 {
 // -- Declaration --
 class Node;
+class PointwiseNode;
 class EvaluatorObserver;
 
 class Evaluator
@@ -35,23 +49,131 @@ private:
 
     NodeID m_nextNodeID = 1;
 
+    // Incremented on every change to the graph
+    std::uint64_t m_revision = 0;
+
     std::unordered_map<NodeID, std::unique_ptr<Node>> m_nodes;
     std::map<NodeID, TextureOutputNode*> m_outputNodes;
 
     std::unordered_map<InputPortLocator, Connection> m_inputConnections;
     std::unordered_map<OutputPortLocator, std::vector<Connection>> m_outputConnections;
 
-    std::unordered_map<NodeID, bool> m_dirtyFlags;
-    std::unordered_map<NodeID, std::unordered_map<PortID, NodeData>> m_nodeCaches;
+    // Compiled execution plan: every node in topological order, with its outputs stored in integer slots.
+    // Rebuilt when nodes or connections change, so evaluation itself only indexes into vectors.
+    static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+    struct PlanInput
+    {
+        size_t sourceStep = NO_SLOT;
+        size_t slot = NO_SLOT;
+    };
+
+    struct PlanStep
+    {
+        NodeID nodeId;
+        const Node* node;
+        const PointwiseNode* pointwise; // nullptr unless the node can be fused
+
+        std::vector<PlanInput> inputs; // One per input port, NO_SLOT when unconnected
+        size_t firstOutputSlot;
+        size_t outputCount;
+
+        std::vector<size_t> dependents; // One per outgoing connection
+    };
+
+    std::vector<PlanStep> m_plan;
+    std::unordered_map<NodeID, size_t> m_planIndices; // Used while editing only
+    std::vector<std::optional<NodeData>> m_outputSlots;
+    std::vector<std::uint8_t> m_dirtySteps; // Not std::vector<bool>: steps are written from several threads
+    // Outputs that have a connection or were requested through evaluate(); nodes may skip all others.
+    // Recomputed by compilePlan, so a requested output stays demanded until the graph changes.
+    std::vector<std::uint8_t> m_demandedSlots;
+    // Whether the cached slot was calculated. Skipped outputs and the inner links of fused chains are not.
+    std::vector<std::uint8_t> m_calculatedSlots;
+    // Content key of every slot's data, see ResultCache. Also set for uncalculated slots.
+    std::vector<ResultCache::Key> m_slotKeys;
+    // Conversions of every slot's data, so consumers that need the same conversion share it.
+    // Set together with the data; shared with the slot's cache entry.
+    std::vector<std::shared_ptr<ResultCache::Conversions>> m_slotConversions;
+    PlanInput m_finalOutput;
 
     std::vector<EvaluatorObserver*> m_observers;
 
+    // Last final output and the node data it was converted from; reused while the source is unchanged
+    NodeData m_lastOutputSource;
+    std::shared_ptr<PixelBuffer> m_lastOutput;
+    std::uint64_t m_outputGeneration = 0;
+
+    unsigned int m_threadCount;
+    std::unique_ptr<Utils::ThreadPool> m_threadPool;
+
+    std::shared_ptr<VectorFieldBuffer> m_uvField; // See EvaluationContext::uvField
+
+    // Dirty steps are looked up here before they are calculated
+    ResultCache m_resultCache;
+
     NodeID generateNextNodeID();
+    NodeID createNode(const std::type_index& typeIndex, NodeID nodeId);
+
+    void compilePlan();
 
     void propagateDirtyFlag(NodeID nodeId);
+    void markStepDirty(size_t stepIndex);
     bool checkForCycle(NodeID sourceNode, NodeID targetNode);
 
-    static NodeData convertValueToNodeData(const InputPortValue& value, const sf::Vector2u& bufferSize);
+    static NodeData convertValueToNodeData(const InputPortValue& value);
+
+    bool hasValidCache(size_t stepIndex, const sf::Vector2u& bufferSize) const;
+
+    // @brief Returns the steps `source` depends on that have no valid cache, in topological order.
+    std::vector<size_t> collectStepsToCalculate(const PlanInput& source, const sf::Vector2u& bufferSize) const;
+
+    // @brief Calculates `order` (topologically sorted), running steps whose inputs are ready concurrently.
+    void calculateSteps(const std::vector<size_t>& order, const EvaluationContext& context);
+    void calculateStep(size_t stepIndex, const EvaluationContext& context);
+
+    // Pointwise steps whose only consumer is the next pointwise step are calculated as one chain:
+    // every kernel runs over the same tile of the output buffer, so only the last link writes to memory.
+    // Width of such a tile in pixels, small enough to stay in the L1 cache between the kernels.
+    static constexpr unsigned int FUSED_TILE_WIDTH = 256;
+
+    struct ChainLink
+    {
+        size_t stepIndex;
+        size_t chainedInput = NO_SLOT; // The input fed by the previous link, NO_SLOT for the first one
+    };
+
+    using Chain = std::vector<ChainLink>;
+
+    // @brief Groups `order` into chains (mostly single steps), sorted so that each one only depends on chains before it.
+    std::vector<Chain> buildChains(const std::vector<size_t>& order, size_t targetStep) const;
+    void calculateChain(std::span<const ChainLink> chain, const EvaluationContext& context);
+    // @brief Returns false without calculating anything when the first link has a uniform result.
+    bool calculateFusedChain(std::span<const ChainLink> chain, const EvaluationContext& context);
+
+    NodeInputs gatherInputs(size_t stepIndex, const EvaluationContext& context, size_t skippedInput = NO_SLOT);
+    // @brief The slot's data as an input port of `type` reads it, converted at most once per result.
+    NodeData getSlotDataAs(size_t slot, DataType type, const sf::Vector2u& bufferSize);
+    // @brief Drops the slot's data together with its conversions.
+    void resetSlot(size_t slot);
+
+    // @brief What the step's results depend on: its node type, the buffer size and the keys of its current input data.
+    ResultCache::Signature computeStepSignature(size_t stepIndex, const sf::Vector2u& bufferSize) const;
+    static ResultCache::Key computeResultKey(ResultCache::Key stepKey, size_t outputIndex, const std::optional<NodeData>& result);
+
+    // @brief Takes the step's results from m_resultCache. Returns false if a demanded output is not cached.
+    bool restoreCachedResults(size_t stepIndex, const ResultCache::Signature& signature);
+
+    NodeData evaluatePlanInput(const PlanInput& source, const sf::Vector2u& bufferSize, std::stop_token stopToken);
+
+    // @brief Fits the cache and the slots into the cache budget, evicting entries before releasing slots.
+    //        The slots of `requiredOutput` and the final output are kept.
+    void trimMemory(const PlanInput& requiredOutput);
+    // @brief Everything the evaluator keeps alive besides the cache: slot data, conversions and the UV field.
+    std::vector<NodeData> collectLiveData() const;
+
+    // @brief The shared default coordinate field for `bufferSize`, rebuilt only when the size changes.
+    const std::shared_ptr<VectorFieldBuffer>& getUVField(const sf::Vector2u& bufferSize);
 
     void notifyNodeAdded(NodeID id, const Node& node) const;
     void notifyNodeRemoved(NodeID id) const;
@@ -81,8 +203,31 @@ public:
     void addObserver(EvaluatorObserver* observer);
     void removeObserver(EvaluatorObserver* observer);
 
-    NodeData evaluate(NodeID nodeId, const PortID& portId, const sf::Vector2u& bufferSize);
-    std::shared_ptr<PixelBuffer> evaluateFinalOutput(const sf::Vector2u& bufferSize);
+    // @brief Number of threads node kernels are split across. 0 selects the number of hardware threads,
+    //        1 evaluates everything on the calling thread.
+    void setThreadCount(unsigned int threadCount);
+    [[nodiscard]] unsigned int getThreadCount() const;
+
+    // @brief Bytes the cache of earlier results and the current results of all nodes may keep alive together
+    //        (see ResultCache). Over the budget, current results other than the evaluated output are released
+    //        and calculated again (or taken from the cache) when they are needed next.
+    void setResultCacheBudget(size_t maxBytes);
+    [[nodiscard]] ResultCache::Stats getResultCacheStats() const;
+
+    [[nodiscard]] std::uint64_t getRevision() const;
+
+    [[nodiscard]] GraphSnapshot createSnapshot() const;
+
+    // @brief Makes this graph identical to `snapshot`, keeping the caches of unchanged nodes.
+    void applySnapshot(const GraphSnapshot& snapshot);
+
+    // @brief Throws EvaluationCancelled when `stopToken` is triggered before the evaluation finished.
+    NodeData evaluate(NodeID nodeId, const PortID& portId, const sf::Vector2u& bufferSize, std::stop_token stopToken = {});
+    std::shared_ptr<PixelBuffer> evaluateFinalOutput(const sf::Vector2u& bufferSize, std::stop_token stopToken = {});
+
+    // @brief Incremented whenever evaluateFinalOutput returns a different buffer than before;
+    //        the same buffer is returned as long as nothing upstream was recalculated.
+    [[nodiscard]] std::uint64_t getOutputGeneration() const;
 };
 
 } // namespace PGS::NodeGraph
@@ -111,5 +256,6 @@ void PGS::NodeGraph::Evaluator::setNodeInputPortValue(const NodeID& nodeId, cons
     {
         nodeIt->second->setInputPortValue<T>(portId, value);
         propagateDirtyFlag(nodeId);
+        ++m_revision;
     }
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "PGS/node_graph/types.h"
+
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace PGS::NodeGraph
+{
+
+// Plain copy of a node graph: node types, editable input values and connections.
+// Used to hand the graph over to another Evaluator (e.g. on a background thread).
+struct GraphSnapshot
+{
+    struct NodeState
+    {
+        NodeID id;
+        std::type_index type;
+        std::vector<std::pair<PortID, InputPortValue>> values;
+    };
+
+    std::vector<NodeState> nodes;
+    std::vector<Connection> connections;
+};
+
+} // namespace PGS::NodeGraph
@@ -1,19 +1,33 @@
 #pragma once
 
 #include "PGS/node_graph/converters.h"
+#include "PGS/node_graph/node_io.h"
 #include "PGS/node_graph/types.h"
+#include "PGS/node_graph/uniform_input.h"
 
 #include <stdexcept>
+#include <type_traits>
 
 namespace PGS::NodeGraph
 {
 
+    template <typename T, typename Variant>
+    struct IsVariantAlternative;
+
+    template <typename T, typename... Alternatives>
+    struct IsVariantAlternative<T, std::variant<Alternatives...>>
+        : std::bool_constant<(std::is_same_v<T, Alternatives> || ...)> {};
+
     template <typename T>
     std::optional<T> getNodeDataAs(const NodeData& data)
     {
-        if (std::holds_alternative<T>(data))
+        // Views such as ColorInput are never stored, they are only produced by convertTo
+        if constexpr (IsVariantAlternative<T, NodeData>::value)
         {
-            return std::get<T>(data);
+            if (std::holds_alternative<T>(data))
+            {
+                return std::get<T>(data);
+            }
         }
         return std::nullopt;
     }
@@ -55,20 +69,30 @@ namespace PGS::NodeGraph
             // -- Goal: Grayscale --
             if constexpr (std::is_same_v<T, std::shared_ptr<GrayscaleBuffer>>)
             {
-                if constexpr (std::is_same_v<ArgType, std::shared_ptr<PixelBuffer>>) {
+                if constexpr (std::is_same_v<ArgType, std::shared_ptr<ColorBuffer>>) {
                     return toGrayscale(arg);
                 }
-                if constexpr (std::is_same_v<ArgType, float>) {
+                if constexpr (std::is_same_v<ArgType, float> || std::is_same_v<ArgType, FloatColor>) {
                     return toGrayscale(arg, targetSize);
                 }
             }
 
-            // -- Goal: PixelBuffer --
-            if constexpr (std::is_same_v<T, std::shared_ptr<PixelBuffer>>) {
+            // -- Goal: ColorBuffer --
+            if constexpr (std::is_same_v<T, std::shared_ptr<ColorBuffer>>) {
                 if constexpr (std::is_same_v<ArgType, std::shared_ptr<GrayscaleBuffer>>) {
+                    return toColorBuffer(arg);
+                }
+                if constexpr (std::is_same_v<ArgType, float> || std::is_same_v<ArgType, FloatColor>) {
+                    return toColorBuffer(arg, targetSize);
+                }
+            }
+
+            // -- Goal: PixelBuffer (the 8-bit final output, never a node input) --
+            if constexpr (std::is_same_v<T, std::shared_ptr<PixelBuffer>>) {
+                if constexpr (std::is_same_v<ArgType, std::shared_ptr<ColorBuffer>> || std::is_same_v<ArgType, std::shared_ptr<GrayscaleBuffer>>) {
                     return toPixel(arg);
                 }
-                if constexpr (std::is_same_v<ArgType, float>) {
+                if constexpr (std::is_same_v<ArgType, float> || std::is_same_v<ArgType, FloatColor>) {
                     return toPixel(arg, targetSize);
                 }
             }
@@ -78,9 +102,38 @@ namespace PGS::NodeGraph
                 if constexpr (std::is_same_v<ArgType, std::shared_ptr<GrayscaleBuffer>>) {
                     return toVectorField(arg);
                 }
-                if constexpr (std::is_same_v<ArgType, std::shared_ptr<PixelBuffer>>) {
+                if constexpr (std::is_same_v<ArgType, std::shared_ptr<ColorBuffer>>) {
                     return toVectorField(arg);
                 }
+                if constexpr (std::is_same_v<ArgType, FloatColor>) {
+                    return toVectorField(arg, targetSize);
+                }
+            }
+
+            // -- Goal: ColorInput (uniform values stay uniform) --
+            if constexpr (std::is_same_v<T, ColorInput>) {
+                if constexpr (std::is_same_v<ArgType, std::shared_ptr<ColorBuffer>> || std::is_same_v<ArgType, FloatColor>) {
+                    return ColorInput{arg};
+                }
+                if constexpr (std::is_same_v<ArgType, std::shared_ptr<GrayscaleBuffer>>) {
+                    return ColorInput{toColorBuffer(arg)};
+                }
+                if constexpr (std::is_same_v<ArgType, float>) {
+                    return ColorInput{toColor(arg)};
+                }
+            }
+
+            // -- Goal: GrayscaleInput (uniform values stay uniform) --
+            if constexpr (std::is_same_v<T, GrayscaleInput>) {
+                if constexpr (std::is_same_v<ArgType, std::shared_ptr<GrayscaleBuffer>> || std::is_same_v<ArgType, float>) {
+                    return GrayscaleInput{arg};
+                }
+                if constexpr (std::is_same_v<ArgType, std::shared_ptr<ColorBuffer>>) {
+                    return GrayscaleInput{toGrayscale(arg)};
+                }
+                if constexpr (std::is_same_v<ArgType, FloatColor>) {
+                    return GrayscaleInput{toLuminance(arg)};
+                }
             }
 
             // -- Goal: float --
@@ -119,15 +172,15 @@ namespace PGS::NodeGraph
     }
 
     template <typename T>
-    T getRequiredInput(const std::unordered_map<PortID, NodeData>& inputs, const PortID& portId, const sf::Vector2u& bufferSize)
+    T getRequiredInput(const NodeInputs& inputs, const PortID& portId, const sf::Vector2u& bufferSize)
     {
-        const auto it = inputs.find(portId);
-        if (it == inputs.end())
+        const NodeData* const dataPtr = inputs.find(portId);
+        if (dataPtr == nullptr)
         {
-            throw std::runtime_error("FATAL ERROR: Required input data for port '" + portId + "' was not provided by the evaluator.");
+            throw std::runtime_error("FATAL ERROR: Required input data for port '" + portId.str() + "' was not provided by the evaluator.");
         }
 
-        const NodeData& data = it->second;
+        const NodeData& data = *dataPtr;
 
         auto valueOpt = getConvertedNodeData<T>(data, bufferSize);
 
@@ -135,7 +188,7 @@ namespace PGS::NodeGraph
         {
             return *valueOpt;
         }
-        throw std::runtime_error("FATAL ERROR: Type mismatch for input port: " + portId);
+        throw std::runtime_error("FATAL ERROR: Type mismatch for input port: " + portId.str());
     }
 
 } // namespace PGS::NodeGraph
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "PGS/node_graph/types.h"
+#include "PGS/node_graph/evaluation_context.h"
+#include "PGS/node_graph/node_io.h"
 
 #include <SFML/System/Vector2.hpp>
 
@@ -47,8 +49,7 @@ public:
     void setInputPortValue(const PortID& id, T value);
 
     // -- Main Methods --
-    virtual std::unordered_map<PortID, NodeData> calculate(
-        std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const = 0;
+    virtual NodeOutputs calculate(const NodeInputs& inputs, const EvaluationContext& context) const = 0;
 
 protected:
     void registerInputPort(InputPort port);
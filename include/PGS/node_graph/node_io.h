@@ -0,0 +1,53 @@
+#pragma once
+
+#include "PGS/node_graph/types.h"
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace PGS::NodeGraph
+{
+
+// Inputs of a node calculation, stored in the order the node registered its input ports.
+// The evaluator fills them by port index; ports without data (e.g. an unconnected vector input) stay empty.
+class NodeInputs
+{
+private:
+    const std::vector<InputPort>* m_ports;
+    std::vector<std::optional<NodeData>> m_values;
+
+public:
+    explicit NodeInputs(const std::vector<InputPort>& ports)
+        : m_ports(&ports)
+        , m_values(ports.size())
+    {}
+
+    void set(const size_t portIndex, NodeData data)
+    {
+        m_values[portIndex] = std::move(data);
+    }
+
+    // @brief Returns nullptr when no data was provided for `portId`.
+    [[nodiscard]] const NodeData* find(const PortID& portId) const
+    {
+        for (size_t i = 0; i < m_values.size(); ++i)
+        {
+            if ((*m_ports)[i].id == portId)
+                return m_values[i].has_value() ? &*m_values[i] : nullptr;
+        }
+
+        return nullptr;
+    }
+
+    [[nodiscard]] bool contains(const PortID& portId) const
+    {
+        return find(portId) != nullptr;
+    }
+};
+
+// Results of a node calculation: one entry per output port
+using NodeOutputs = std::vector<std::pair<PortID, NodeData>>;
+
+} // namespace PGS::NodeGraph
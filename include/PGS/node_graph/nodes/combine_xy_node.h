@@ -10,8 +10,7 @@ class CombineXYNode final : public Node
 public:
     CombineXYNode(NodeID id, std::string name);
 
-    std::unordered_map<PortID, NodeData> calculate(
-        std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const override;
+    NodeOutputs calculate(const NodeInputs& inputs, const EvaluationContext& context) const override;
 };
 
 } // namespace PGS::NodeGraph
\ No newline at end of file
@@ -1,17 +1,19 @@
 #pragma once
 
-#include "PGS/node_graph/node.h"
+#include "PGS/node_graph/pointwise_node.h"
 
 namespace PGS::NodeGraph
 {
 
-class InvertColorNode final : public Node
+class InvertColorNode final : public PointwiseNode
 {
 public:
     InvertColorNode(NodeID id, std::string name);
 
-    std::unordered_map<PortID, NodeData> calculate(
-        std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const override;
+    NodeOutputs calculate(const NodeInputs& inputs, const EvaluationContext& context) const override;
+
+    PointwiseKernel createPointwiseKernel(const NodeInputs& inputs, const std::optional<PortID>& chainedPort,
+                                          const EvaluationContext& context) const override;
 };
 
 } // namespace PGS::NodeGraph
\ No newline at end of file
@@ -9,8 +9,7 @@ class VoronoiTextureNode final : public Node {
 public:
     VoronoiTextureNode(NodeID id, std::string name);
 
-    std::unordered_map<PortID, NodeData> calculate(
-        std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const override;
+    NodeOutputs calculate(const NodeInputs& inputs, const EvaluationContext& context) const override;
 
     enum FeatureType {
         F1 = 0,
@@ -28,6 +27,8 @@ private:
 
     static sf::Color idToColor(size_t id);
 
+    // @brief Number of cells per axis, feature point i lies in cell (i % size, i / size)
+    static int getGridSize(float scale);
     static std::vector<sf::Vector2f> generateFeaturePoints(float scale, float randomness, int seed = 0);
 };
 
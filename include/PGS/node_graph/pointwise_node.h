@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PGS/node_graph/node.h"
+#include "PGS/core/buffers/float_color.h"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace PGS
+{
+    class ColorBuffer;
+}
+
+namespace PGS::NodeGraph
+{
+
+// Computes `pixels.size()` output colors of row `y`, starting at column `xBegin`.
+// If the kernel was created with a chained port, `pixels` holds that input on entry and is overwritten in place.
+using PointwiseKernel = std::function<void(unsigned int y, unsigned int xBegin, std::span<FloatColor> pixels)>;
+
+// Node with a single color output whose every pixel depends only on the same pixel of its inputs.
+// The evaluator fuses chains of such nodes into one loop, so the intermediate colors never leave the cache.
+class PointwiseNode : public Node
+{
+public:
+    using Node::Node;
+
+    // @brief Returns the kernel for `inputs`, or nullptr when the result is uniform and needs no buffer.
+    //        `chainedPort` is missing from `inputs`: the kernel reads it from the pixels it is given instead.
+    [[nodiscard]] virtual PointwiseKernel createPointwiseKernel(const NodeInputs& inputs, const std::optional<PortID>& chainedPort,
+                                                                const EvaluationContext& context) const = 0;
+
+protected:
+    // @brief Runs `kernel` over a new buffer of the context size.
+    static std::shared_ptr<ColorBuffer> runKernel(const PointwiseKernel& kernel, const EvaluationContext& context);
+};
+
+} // namespace PGS::NodeGraph
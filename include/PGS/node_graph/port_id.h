@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace PGS::NodeGraph
+{
+
+// Interned port identifier.
+// Every distinct name is stored once in a global registry and the handle points at it,
+// so comparing, hashing and copying never touch the characters.
+// Creating a handle from a name locks and hashes, so hot code should keep handles in constants.
+class PortID
+{
+private:
+    const std::string* m_name;
+
+    static const std::string* intern(std::string_view name);
+
+public:
+    PortID();
+    PortID(const char* name);
+    PortID(const std::string& name);
+    PortID(std::string_view name);
+
+    // @brief Name of the port, for display and serialization only.
+    [[nodiscard]] const std::string& str() const { return *m_name; }
+
+    [[nodiscard]] bool empty() const { return m_name->empty(); }
+
+    bool operator==(const PortID& other) const { return m_name == other.m_name; }
+
+    // Orders by name, so sorted output does not depend on the interning order
+    bool operator<(const PortID& other) const { return m_name != other.m_name && *m_name < *other.m_name; }
+
+    friend struct std::hash<PortID>;
+};
+
+std::ostream& operator<<(std::ostream& stream, const PortID& portId);
+std::istream& operator>>(std::istream& stream, PortID& portId);
+
+} // namespace PGS::NodeGraph
+
+template<>
+struct std::hash<PGS::NodeGraph::PortID>
+{
+    size_t operator()(const PGS::NodeGraph::PortID& portId) const noexcept
+    {
+        return std::hash<const std::string*>{}(portId.m_name);
+    }
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "PGS/node_graph/types.h"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace PGS::NodeGraph
+{
+
+// Node results by content key: a hash of everything a result depends on (node type, buffer size,
+// the keys of its input data). Equal keys mean equal results, so when a key comes back (a value toggled
+// back and forth, an undo, a size switched back) the result is reused instead of calculated again.
+// Entries are kept within a byte budget, the least recently used ones are dropped first. The budget also
+// covers the data the owner keeps alive besides the entries (see trim); every buffer is counted once.
+// Safe to use from several threads.
+class ResultCache
+{
+public:
+    using Key = std::uint64_t;
+
+    // What a result was calculated from. Entries are looked up by `key`, the hash of `inputs`;
+    // the inputs are compared on every hit, so two results whose keys collide are never mixed up.
+    struct Signature
+    {
+        Key key = 0;
+        std::vector<Key> inputs;
+    };
+
+    // One output converted to the types of the ports that read it (a color buffer read as grayscale, ...).
+    // Shared by the slot holding the output and its entry, so a restored output is not converted again.
+    struct Conversions
+    {
+        explicit Conversions(const sf::Vector2u& bufferSize) : bufferSize(bufferSize) {}
+
+        const sf::Vector2u bufferSize; // Uniform outputs are converted to buffers of this size
+
+        std::mutex mutex;
+        std::array<std::optional<NodeData>, 4> byType; // Indexed by DataType
+    };
+
+    struct Entry
+    {
+        std::vector<std::optional<NodeData>> outputs;          // One per output port
+        std::vector<std::uint8_t> calculated;                  // Outputs that were skipped are not
+        std::vector<std::shared_ptr<Conversions>> conversions; // One per output port
+    };
+
+    struct Stats
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t entryCount = 0;
+        size_t residentBytes = 0; // Entries and live data, buffers shared between them counted once
+        size_t liveBytes = 0;     // Part of residentBytes kept alive only by the live data, as of the last trim
+    };
+
+    // @brief Returns a copy of the entry and marks it as recently used; buffers are shared, not copied.
+    //        An entry stored under the same key for other inputs counts as a miss.
+    [[nodiscard]] std::optional<Entry> find(const Signature& signature);
+    // @brief An entry larger than the whole budget is not stored.
+    void insert(const Signature& signature, Entry entry);
+
+    // @brief Counts `liveData`, the data the owner keeps alive besides the entries, towards the budget and
+    //        evicts entries until the total fits. Also counts conversions added to entries after they were inserted.
+    // @return Whether the total fits the budget. It does not when the live data alone is larger.
+    bool trim(std::span<const NodeData> liveData);
+
+    void setMaxBytes(size_t maxBytes);
+    [[nodiscard]] size_t getMaxBytes() const;
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    static constexpr size_t DEFAULT_MAX_BYTES = 512 * 1024 * 1024;
+
+    struct StoredEntry
+    {
+        Entry entry;
+        std::vector<Key> inputs;
+        std::vector<const void*> buffers; // Counted in m_buffers, conversions included
+        size_t valueBytes;                // Plain values (float, etc.), never shared
+        std::list<Key>::iterator usePosition;
+    };
+
+    struct BufferUse
+    {
+        size_t bytes;
+        size_t entryCount;
+    };
+
+    using LiveBuffers = std::unordered_set<const void*>;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<Key, StoredEntry> m_entries;
+    std::list<Key> m_useOrder; // Most recently used first
+
+    // Every distinct buffer kept alive by the entries
+    std::unordered_map<const void*, BufferUse> m_buffers;
+    size_t m_entryBytes = 0; // Buffers in m_buffers and the values of all entries
+    size_t m_liveBytes = 0;  // Live data not kept by any entry, as of the last trim
+
+    size_t m_maxBytes = DEFAULT_MAX_BYTES;
+    Stats m_stats;
+
+    // @brief The buffer behind `data` and its size, nullptr and the size of the value for plain values.
+    static std::pair<const void*, size_t> describe(const NodeData& data);
+    // @brief Size of the data the entry keeps alive on its own. Buffers it holds several times are counted once.
+    static size_t computeBytes(const Entry& entry);
+
+    void countOutput(StoredEntry& stored, const NodeData& data);
+    void countConversions(StoredEntry& stored);
+    // @brief Buffers of the entry that are in `live` move to m_liveBytes when no other entry keeps them.
+    void uncountEntry(const StoredEntry& stored, const LiveBuffers* live);
+
+    void evict(size_t maxBytes, const LiveBuffers* live = nullptr);
+};
+
+} // namespace PGS::NodeGraph
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+
+namespace PGS::NodeGraph
+{
+class Evaluator;
+}
+
+// Plain-text graph format, one statement per line ('#' starts a comment):
+//
+//     node <id> <node type name>            e.g. `node 2 Noise Texture`
+//     set  <id> <port id> <value...>        e.g. `set 2 in_scale 8`, `set 3 in_color1 255 0 0 255`
+//     link <source id> <source port id> <target id> <target port id>
+//
+// IDs are local to the file. The first `Texture Output` node of the file is mapped onto
+// the output node that every Evaluator already owns.
+namespace PGS::NodeGraph::Serialization
+{
+    // @brief Reads a graph from `input` into `evaluator`. Throws std::runtime_error on malformed input.
+    void loadGraph(Evaluator& evaluator, std::istream& input);
+
+    // @brief Writes nodes, input port values and connections of `evaluator` to `output`.
+    void saveGraph(const Evaluator& evaluator, std::ostream& output);
+
+} // namespace PGS::NodeGraph::Serialization
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "PGS/core/buffers/float_color.h"
+#include "PGS/node_graph/port_id.h"
+
 #include <SFML/Graphics/Color.hpp>
 
 #include <variant>
@@ -12,7 +15,7 @@
 namespace PGS
 {
     class GrayscaleBuffer;
-    class PixelBuffer;
+    class ColorBuffer;
     class VectorFieldBuffer;
 }
 
@@ -22,7 +25,6 @@ namespace PGS::NodeGraph
 
 
     using NodeID = size_t;
-    using PortID = std::string;
 
     using ValueList = std::pair<int, std::vector<const char*>>;
 
@@ -78,11 +80,14 @@ namespace PGS::NodeGraph
         }
     };
 
+    // float and FloatColor are uniform values: they are broadcast to a buffer only when a node needs one.
+    // Everything stays in float32 between nodes, only the final output is quantized to RGBA8.
     using NodeData = std::variant<
         std::shared_ptr<GrayscaleBuffer>,
-        std::shared_ptr<PixelBuffer>,
+        std::shared_ptr<ColorBuffer>,
         std::shared_ptr<VectorFieldBuffer>,
-        float
+        float,
+        FloatColor
     >;
 
     // Helpers
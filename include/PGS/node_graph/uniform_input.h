@@ -0,0 +1,123 @@
+#pragma once
+
+#include "PGS/core/buffers/color_buffer.h"
+#include "PGS/core/buffers/grayscale_buffer.h"
+
+#include "PGS/node_graph/types.h"
+
+#include <memory>
+
+namespace PGS::NodeGraph
+{
+
+// Read-only view of a color input: either a full ColorBuffer or one uniform color.
+// Unconnected color ports arrive as a uniform color, so nodes can read them per pixel
+// without the evaluator filling a full-size buffer first.
+class ColorInput
+{
+public:
+    // One row of the input: indexes the buffer row, or repeats the uniform color
+    class Row
+    {
+        friend class ColorInput;
+
+        const FloatColor* m_colors = nullptr;
+        FloatColor m_color;
+
+    public:
+        [[nodiscard]] FloatColor operator[](const unsigned int x) const { return m_colors ? m_colors[x] : m_color; }
+    };
+
+private:
+    std::shared_ptr<ColorBuffer> m_buffer;
+    FloatColor m_color;
+
+public:
+    ColorInput(const FloatColor& color)
+        : m_color(color)
+    {}
+
+    ColorInput(std::shared_ptr<ColorBuffer> buffer)
+        : m_buffer(std::move(buffer))
+    {}
+
+    [[nodiscard]] bool isUniform() const { return m_buffer == nullptr; }
+
+    // @brief The color of a uniform input. Only meaningful if isUniform().
+    [[nodiscard]] const FloatColor& getColor() const { return m_color; }
+    // @brief The buffer of a non-uniform input, nullptr if isUniform().
+    [[nodiscard]] const std::shared_ptr<ColorBuffer>& getBuffer() const { return m_buffer; }
+
+    [[nodiscard]] FloatColor getPixel(const sf::Vector2u& pos) const
+    {
+        return m_buffer ? m_buffer->getColor(pos) : m_color;
+    }
+
+    [[nodiscard]] Row getRow(const unsigned int y) const
+    {
+        Row row;
+        if (m_buffer)
+            row.m_colors = m_buffer->getRow(y).data();
+        row.m_color = m_color;
+        return row;
+    }
+
+    // @brief Returns the data as node output, keeping a uniform color uniform.
+    [[nodiscard]] NodeData toNodeData() const
+    {
+        if (m_buffer)
+            return m_buffer;
+        return m_color;
+    }
+};
+
+// Read-only view of a grayscale input: either a full GrayscaleBuffer or one uniform value.
+class GrayscaleInput
+{
+public:
+    // One row of the input: indexes the buffer row, or repeats the uniform value
+    class Row
+    {
+        friend class GrayscaleInput;
+
+        const float* m_values = nullptr;
+        float m_value = 0.0f;
+
+    public:
+        [[nodiscard]] float operator[](const unsigned int x) const { return m_values ? m_values[x] : m_value; }
+    };
+
+private:
+    std::shared_ptr<GrayscaleBuffer> m_buffer;
+    float m_value = 0.0f;
+
+public:
+    GrayscaleInput(const float value)
+        : m_value(value)
+    {}
+
+    GrayscaleInput(std::shared_ptr<GrayscaleBuffer> buffer)
+        : m_buffer(std::move(buffer))
+    {}
+
+    [[nodiscard]] bool isUniform() const { return m_buffer == nullptr; }
+
+    // @brief The value of a uniform input. Only meaningful if isUniform().
+    [[nodiscard]] float getUniformValue() const { return m_value; }
+
+    [[nodiscard]] float getValue(const sf::Vector2u& pos) const
+    {
+        return m_buffer ? m_buffer->getValue(pos) : m_value;
+    }
+
+    [[nodiscard]] Row getRow(const unsigned int y) const
+    {
+        Row row;
+        if (m_buffer)
+            row.m_values = m_buffer->getRow(y).data();
+        row.m_value = m_value;
+        return row;
+    }
+};
+
+} // namespace PGS::NodeGraph
@@ -1,15 +1,14 @@
 #pragma once
 
-#include <cstdint>
-#include <SFML/Graphics/Color.hpp>
+#include "PGS/core/buffers/float_color.h"
 
 namespace PGS::NodeGraph::Utils
 {
-inline uint8_t lerp(const uint8_t valueA, const uint8_t valueB, const float t) {
-    return static_cast<uint8_t>(static_cast<float>(valueA) * (1.0f - t) + static_cast<float>(valueB) * t);
+inline float lerp(const float valueA, const float valueB, const float t) {
+    return valueA * (1.0f - t) + valueB * t;
 }
 
-inline sf::Color lerpColor(const sf::Color& colorA, const sf::Color& colorB, const float t) {
+inline FloatColor lerpColor(const FloatColor& colorA, const FloatColor& colorB, const float t) {
     return {
         lerp(colorA.r, colorB.r, t),
         lerp(colorA.g, colorB.g, t),
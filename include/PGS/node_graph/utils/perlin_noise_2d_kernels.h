@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+// SIMD batch kernels behind PerlinNoise2D::getValues.
+// Each kernel lives in its own translation unit compiled for its instruction set,
+// so they must only be called after checking the CPU supports it.
+namespace PGS::NodeGraph::Utils::PerlinKernels
+{
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PGS_PERLIN_X86_KERNELS 1
+
+// @brief `table` is a PerlinNoise2D::PermutationTable (512 entries).
+void evaluateSse41(const int* table, const float* xs, const float* ys, float* values, std::size_t count);
+void evaluateAvx2(const int* table, const float* xs, const float* ys, float* values, std::size_t count);
+#endif
+
+} // namespace PGS::NodeGraph::Utils::PerlinKernels
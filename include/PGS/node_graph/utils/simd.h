@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Portable 4-lane float SIMD: SSE2 (part of every x86-64 CPU) or NEON (every ARMv8 CPU), scalar elsewhere.
+// Both are baseline instruction sets, so unlike the Perlin kernels no flags or runtime checks are needed.
+// Every operation rounds like its scalar counterpart: a kernel that performs the same operations in
+// the same order as a scalar loop gives the same results.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PGS_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define PGS_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace PGS::NodeGraph::Utils::Simd
+{
+
+constexpr size_t LANES = 4;
+
+#if defined(PGS_SIMD_SSE2)
+using Float4 = __m128;
+
+inline Float4 load(const float* source) { return _mm_loadu_ps(source); }
+inline void store(float* destination, const Float4 value) { _mm_storeu_ps(destination, value); }
+inline Float4 set1(const float value) { return _mm_set1_ps(value); }
+
+inline Float4 add(const Float4 a, const Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub(const Float4 a, const Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul(const Float4 a, const Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 div(const Float4 a, const Float4 b) { return _mm_div_ps(a, b); }
+inline Float4 sqrt(const Float4 value) { return _mm_sqrt_ps(value); }
+inline Float4 abs(const Float4 value) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), value); }
+
+// Same results as std::min and std::max, including for NaN and signed zeros: (b < a) ? b : a and (a < b) ? b : a
+inline Float4 min(const Float4 a, const Float4 b) { return _mm_min_ps(b, a); }
+inline Float4 max(const Float4 a, const Float4 b) { return _mm_max_ps(b, a); }
+
+// All bits of a lane set where the condition holds
+using Mask4 = __m128;
+
+inline Mask4 lessThan(const Float4 a, const Float4 b) { return _mm_cmplt_ps(a, b); }
+inline Mask4 equal(const Float4 a, const Float4 b) { return _mm_cmpeq_ps(a, b); }
+inline Mask4 laneMask(const bool lane0, const bool lane1, const bool lane2, const bool lane3)
+{
+    return _mm_castsi128_ps(_mm_setr_epi32(-static_cast<int>(lane0), -static_cast<int>(lane1),
+                                           -static_cast<int>(lane2), -static_cast<int>(lane3)));
+}
+// @brief mask ? ifTrue : ifFalse, per lane.
+inline Float4 select(const Mask4 mask, const Float4 ifTrue, const Float4 ifFalse)
+{
+    return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+// @brief std::min(std::max(0.0f, value), 1.0f): NaN becomes 0, as max returns its second operand then.
+inline Float4 clamp01(const Float4 value) { return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f)); }
+
+// @brief Rounds toward zero, like a conversion to int and back.
+inline Float4 trunc(const Float4 value)
+{
+    // From 2^23 on floats are integers already, and larger ones would overflow the conversion
+    const Float4 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+    return select(lessThan(abs(value), _mm_set1_ps(8388608.0f)), truncated, value);
+}
+
+// @brief Splits 4 interleaved RGBA pixels into one register per channel.
+inline void loadInterleaved(const float* source, Float4& r, Float4& g, Float4& b, Float4& a)
+{
+    r = _mm_loadu_ps(source);
+    g = _mm_loadu_ps(source + 4);
+    b = _mm_loadu_ps(source + 8);
+    a = _mm_loadu_ps(source + 12);
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+}
+
+inline void storeInterleaved(float* destination, Float4 r, Float4 g, Float4 b, Float4 a)
+{
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+    _mm_storeu_ps(destination, r);
+    _mm_storeu_ps(destination + 4, g);
+    _mm_storeu_ps(destination + 8, b);
+    _mm_storeu_ps(destination + 12, a);
+}
+
+// @brief Truncates 16 values in [0, 256) to bytes, in order.
+inline void storeBytes(std::uint8_t* destination, const Float4 v0, const Float4 v1, const Float4 v2, const Float4 v3)
+{
+    const __m128i low = _mm_packs_epi32(_mm_cvttps_epi32(v0), _mm_cvttps_epi32(v1));
+    const __m128i high = _mm_packs_epi32(_mm_cvttps_epi32(v2), _mm_cvttps_epi32(v3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_packus_epi16(low, high));
+}
+
+#elif defined(PGS_SIMD_NEON)
+using Float4 = float32x4_t;
+
+inline Float4 load(const float* source) { return vld1q_f32(source); }
+inline void store(float* destination, const Float4 value) { vst1q_f32(destination, value); }
+inline Float4 set1(const float value) { return vdupq_n_f32(value); }
+
+inline Float4 add(const Float4 a, const Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub(const Float4 a, const Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul(const Float4 a, const Float4 b) { return vmulq_f32(a, b); }
+inline Float4 div(const Float4 a, const Float4 b) { return vdivq_f32(a, b); }
+inline Float4 sqrt(const Float4 value) { return vsqrtq_f32(value); }
+inline Float4 abs(const Float4 value) { return vabsq_f32(value); }
+
+using Mask4 = uint32x4_t;
+
+inline Mask4 lessThan(const Float4 a, const Float4 b) { return vcltq_f32(a, b); }
+inline Mask4 equal(const Float4 a, const Float4 b) { return vceqq_f32(a, b); }
+inline Mask4 laneMask(const bool lane0, const bool lane1, const bool lane2, const bool lane3)
+{
+    const uint32_t lanes[LANES] = {lane0 ? ~0u : 0u, lane1 ? ~0u : 0u, lane2 ? ~0u : 0u, lane3 ? ~0u : 0u};
+    return vld1q_u32(lanes);
+}
+inline Float4 select(const Mask4 mask, const Float4 ifTrue, const Float4 ifFalse) { return vbslq_f32(mask, ifTrue, ifFalse); }
+
+// vminq/vmaxq differ from std::min/std::max for NaN and signed zeros, the comparisons do not
+inline Float4 min(const Float4 a, const Float4 b) { return vbslq_f32(vcltq_f32(b, a), b, a); }
+inline Float4 max(const Float4 a, const Float4 b) { return vbslq_f32(vcltq_f32(a, b), b, a); }
+
+// @brief std::min(std::max(0.0f, value), 1.0f): the "nm" forms return the number when one operand is NaN.
+inline Float4 clamp01(const Float4 value) { return vminnmq_f32(vmaxnmq_f32(value, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f)); }
+
+inline Float4 trunc(const Float4 value) { return vrndq_f32(value); }
+
+inline void loadInterleaved(const float* source, Float4& r, Float4& g, Float4& b, Float4& a)
+{
+    const float32x4x4_t channels = vld4q_f32(source);
+    r = channels.val[0];
+    g = channels.val[1];
+    b = channels.val[2];
+    a = channels.val[3];
+}
+
+inline void storeInterleaved(float* destination, const Float4 r, const Float4 g, const Float4 b, const Float4 a)
+{
+    vst4q_f32(destination, float32x4x4_t{{r, g, b, a}});
+}
+
+inline void storeBytes(std::uint8_t* destination, const Float4 v0, const Float4 v1, const Float4 v2, const Float4 v3)
+{
+    const uint16x8_t low = vcombine_u16(vmovn_u32(vcvtq_u32_f32(v0)), vmovn_u32(vcvtq_u32_f32(v1)));
+    const uint16x8_t high = vcombine_u16(vmovn_u32(vcvtq_u32_f32(v2)), vmovn_u32(vcvtq_u32_f32(v3)));
+    vst1q_u8(destination, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+}
+
+#else
+struct Float4
+{
+    float lanes[LANES];
+};
+
+inline Float4 load(const float* source) { return {{source[0], source[1], source[2], source[3]}}; }
+inline void store(float* destination, const Float4 value) { std::copy_n(value.lanes, LANES, destination); }
+inline Float4 set1(const float value) { return {{value, value, value, value}}; }
+
+template <typename Operation>
+Float4 apply(const Float4 a, const Float4 b, Operation operation)
+{
+    Float4 result;
+    for (size_t i = 0; i < LANES; ++i)
+        result.lanes[i] = operation(a.lanes[i], b.lanes[i]);
+    return result;
+}
+
+inline Float4 add(const Float4 a, const Float4 b) { return apply(a, b, [](const float x, const float y) { return x + y; }); }
+inline Float4 sub(const Float4 a, const Float4 b) { return apply(a, b, [](const float x, const float y) { return x - y; }); }
+inline Float4 mul(const Float4 a, const Float4 b) { return apply(a, b, [](const float x, const float y) { return x * y; }); }
+inline Float4 div(const Float4 a, const Float4 b) { return apply(a, b, [](const float x, const float y) { return x / y; }); }
+inline Float4 sqrt(const Float4 value) { return apply(value, value, [](const float x, float) { return std::sqrt(x); }); }
+inline Float4 abs(const Float4 value) { return apply(value, value, [](const float x, float) { return std::abs(x); }); }
+inline Float4 min(const Float4 a, const Float4 b) { return apply(a, b, [](const float x, const float y) { return std::min(x, y); }); }
+inline Float4 max(const Float4 a, const Float4 b) { return apply(a, b, [](const float x, const float y) { return std::max(x, y); }); }
+
+struct Mask4
+{
+    bool lanes[LANES];
+};
+
+inline Mask4 lessThan(const Float4 a, const Float4 b)
+{
+    return {{a.lanes[0] < b.lanes[0], a.lanes[1] < b.lanes[1], a.lanes[2] < b.lanes[2], a.lanes[3] < b.lanes[3]}};
+}
+inline Mask4 equal(const Float4 a, const Float4 b)
+{
+    return {{a.lanes[0] == b.lanes[0], a.lanes[1] == b.lanes[1], a.lanes[2] == b.lanes[2], a.lanes[3] == b.lanes[3]}};
+}
+inline Mask4 laneMask(const bool lane0, const bool lane1, const bool lane2, const bool lane3) { return {{lane0, lane1, lane2, lane3}}; }
+inline Float4 select(const Mask4 mask, const Float4 ifTrue, const Float4 ifFalse)
+{
+    Float4 result;
+    for (size_t i = 0; i < LANES; ++i)
+        result.lanes[i] = mask.lanes[i] ? ifTrue.lanes[i] : ifFalse.lanes[i];
+    return result;
+}
+
+inline Float4 clamp01(const Float4 value)
+{
+    return apply(value, value, [](const float x, float) { return std::min(std::max(0.0f, x), 1.0f); });
+}
+
+inline Float4 trunc(const Float4 value) { return apply(value, value, [](const float x, float) { return std::trunc(x); }); }
+
+inline void loadInterleaved(const float* source, Float4& r, Float4& g, Float4& b, Float4& a)
+{
+    for (size_t i = 0; i < LANES; ++i)
+    {
+        r.lanes[i] = source[i * 4];
+        g.lanes[i] = source[i * 4 + 1];
+        b.lanes[i] = source[i * 4 + 2];
+        a.lanes[i] = source[i * 4 + 3];
+    }
+}
+
+inline void storeInterleaved(float* destination, const Float4 r, const Float4 g, const Float4 b, const Float4 a)
+{
+    for (size_t i = 0; i < LANES; ++i)
+    {
+        destination[i * 4] = r.lanes[i];
+        destination[i * 4 + 1] = g.lanes[i];
+        destination[i * 4 + 2] = b.lanes[i];
+        destination[i * 4 + 3] = a.lanes[i];
+    }
+}
+
+inline void storeBytes(std::uint8_t* destination, const Float4 v0, const Float4 v1, const Float4 v2, const Float4 v3)
+{
+    for (const Float4& value : {v0, v1, v2, v3})
+    {
+        for (size_t i = 0; i < LANES; ++i)
+            *destination++ = static_cast<std::uint8_t>(value.lanes[i]);
+    }
+}
+#endif
+
+// @brief std::clamp(value, low, high): NaN stays NaN.
+inline Float4 clamp(const Float4 value, const Float4 low, const Float4 high)
+{
+    return select(lessThan(value, low), low, select(lessThan(high, value), high, value));
+}
+
+} // namespace PGS::NodeGraph::Utils::Simd
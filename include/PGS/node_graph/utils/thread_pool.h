@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PGS::NodeGraph::Utils
+{
+
+// Work-stealing thread pool.
+// Every worker owns a task queue: it pops its own tasks LIFO (cache-warm) and steals from the
+// other queues FIFO when it runs dry. Threads waiting for a TaskGroup execute queued tasks
+// instead of blocking, so tasks may safely wait for nested groups.
+class ThreadPool
+{
+public:
+    class TaskGroup
+    {
+        friend class ThreadPool;
+
+        std::atomic<size_t> m_pending{0};
+
+        std::mutex m_errorMutex;
+        std::exception_ptr m_error;
+    };
+
+    // @brief `threadCount` is the total number of threads doing work, including the waiting caller.
+    explicit ThreadPool(unsigned int threadCount);
+    ~ThreadPool();
+
+    // Non-copyable
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]] unsigned int getThreadCount() const;
+
+    void run(TaskGroup& group, std::function<void()> task);
+
+    // @brief Helps executing queued tasks until every task of `group` has finished.
+    //        Rethrows the first exception thrown by a task of the group.
+    void wait(TaskGroup& group);
+
+    // @brief Splits [begin, end) into chunks of at least `grainSize` elements and
+    //        calls `function(chunkBegin, chunkEnd)` for each of them in parallel.
+    void parallelFor(size_t begin, size_t end, size_t grainSize,
+                     const std::function<void(size_t, size_t)>& function);
+
+private:
+    struct Task
+    {
+        std::function<void()> function;
+        TaskGroup* group;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::atomic<size_t> m_queuedTasks{0};
+    std::atomic<size_t> m_nextQueue{0};
+    bool m_stopping = false;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+
+    void workerLoop(size_t index);
+
+    bool tryRunTask(size_t preferredQueue);
+    void execute(Task& task);
+
+    void notifyAll();
+};
+
+} // namespace PGS::NodeGraph::Utils
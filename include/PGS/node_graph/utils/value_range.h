@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <span>
+
+namespace PGS::NodeGraph::Utils
+{
+
+// Smallest and largest of the values seen so far. Empty until the first value is included.
+struct ValueRange
+{
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+
+    void include(const std::span<const float> values)
+    {
+        for (const float value : values) {
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+    }
+
+    void include(const ValueRange& other)
+    {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+};
+
+// Range of the values written by several row bands at once (see EvaluationContext::forEachRowBand).
+// Each band reduces its own rows into a local ValueRange while they are still in the cache and merges
+// it here once, so normalizing needs no separate pass over the whole buffer to find the range.
+class ConcurrentValueRange
+{
+    mutable std::mutex m_mutex;
+    ValueRange m_range;
+
+public:
+    void merge(const ValueRange& range)
+    {
+        std::lock_guard lock(m_mutex);
+        m_range.include(range);
+    }
+
+    [[nodiscard]] ValueRange get() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_range;
+    }
+};
+
+} // namespace PGS::NodeGraph::Utils
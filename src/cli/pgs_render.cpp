@@ -0,0 +1,149 @@
+// pgs-render: evaluates a saved node graph without creating a window, ImGui or ImNodes context.
+//
+// Usage: pgs-render <graph file> <output image> [--size <width>x<height>] [--threads <count>] [--cache-budget <MiB>]
+
+#include "PGS/core/buffers/pixel_buffer.h"
+#include "PGS/node_graph/evaluator.h"
+#include "PGS/node_graph/serialization.h"
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+namespace
+{
+    constexpr sf::Vector2u DEFAULT_SIZE = {256, 256};
+
+    struct Options
+    {
+        std::string graphPath;
+        std::string outputPath;
+        sf::Vector2u size = DEFAULT_SIZE;
+        unsigned int threadCount = 0; // All hardware threads
+        std::optional<size_t> cacheBudget; // Bytes, the evaluator's default if not set
+    };
+
+    void printUsage()
+    {
+        std::cerr << "Usage: pgs-render <graph file> <output image> [--size <width>x<height>] [--threads <count>] [--cache-budget <MiB>]\n";
+    }
+
+    std::optional<sf::Vector2u> parseSize(const std::string& text)
+    {
+        unsigned int width = 0;
+        unsigned int height = 0;
+        char separator = 0;
+
+        if (std::sscanf(text.c_str(), "%u%c%u", &width, &separator, &height) != 3 || separator != 'x')
+            return std::nullopt;
+
+        if (width == 0 || height == 0)
+            return std::nullopt;
+
+        return sf::Vector2u{width, height};
+    }
+
+    std::optional<Options> parseOptions(const int argc, char** argv)
+    {
+        Options options;
+        int positional = 0;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+
+            if (argument == "--size" && i + 1 < argc)
+            {
+                const auto size = parseSize(argv[++i]);
+                if (!size)
+                    return std::nullopt;
+                options.size = *size;
+            }
+            else if (argument == "--threads" && i + 1 < argc)
+            {
+                unsigned int threadCount = 0;
+                if (std::sscanf(argv[++i], "%u", &threadCount) != 1)
+                    return std::nullopt;
+                options.threadCount = threadCount;
+            }
+            else if (argument == "--cache-budget" && i + 1 < argc)
+            {
+                unsigned int megabytes = 0;
+                if (std::sscanf(argv[++i], "%u", &megabytes) != 1)
+                    return std::nullopt;
+                options.cacheBudget = size_t{megabytes} * 1024 * 1024;
+            }
+            else if (positional == 0)
+            {
+                options.graphPath = argument;
+                ++positional;
+            }
+            else if (positional == 1)
+            {
+                options.outputPath = argument;
+                ++positional;
+            }
+            else
+            {
+                return std::nullopt;
+            }
+        }
+
+        if (positional != 2)
+            return std::nullopt;
+
+        return options;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const auto options = parseOptions(argc, argv);
+    if (!options)
+    {
+        printUsage();
+        return 2;
+    }
+
+    try
+    {
+        std::ifstream graphFile{options->graphPath};
+        if (!graphFile)
+        {
+            std::cerr << "Failed to open graph file '" << options->graphPath << "'\n";
+            return 1;
+        }
+
+        PGS::NodeGraph::Evaluator evaluator;
+        evaluator.setThreadCount(options->threadCount);
+        if (options->cacheBudget)
+            evaluator.setResultCacheBudget(*options->cacheBudget);
+        PGS::NodeGraph::Serialization::loadGraph(evaluator, graphFile);
+
+        const auto buffer = evaluator.evaluateFinalOutput(options->size);
+        if (!buffer)
+        {
+            std::cerr << "The graph has nothing connected to its Texture Output node\n";
+            return 1;
+        }
+
+        const sf::Image image{buffer->getSize(), buffer->getData()};
+        if (!image.saveToFile(options->outputPath))
+        {
+            std::cerr << "Failed to write image '" << options->outputPath << "'\n";
+            return 1;
+        }
+    }
+    catch (const std::exception& exception)
+    {
+        std::cerr << exception.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "PGS/core/buffers/buffer_pool.h"
+
+PGS::BufferPool::Block::Block(std::unique_ptr<std::byte[]> memory, const size_t size)
+    : m_memory(std::move(memory))
+    , m_size(size)
+{}
+
+PGS::BufferPool::Block::~Block()
+{
+    if (m_memory)
+        BufferPool::instance().release(std::move(m_memory), m_size);
+}
+
+PGS::BufferPool::Block& PGS::BufferPool::Block::operator=(Block&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_memory)
+            BufferPool::instance().release(std::move(m_memory), m_size);
+
+        m_memory = std::move(other.m_memory);
+        m_size = other.m_size;
+    }
+    return *this;
+}
+
+PGS::BufferPool& PGS::BufferPool::instance()
+{
+    // Leaked on purpose: buffers held by other static objects still return their blocks at exit
+    static auto* pool = new BufferPool();
+    return *pool;
+}
+
+PGS::BufferPool::Block PGS::BufferPool::acquire(const size_t size)
+{
+    if (size == 0)
+        return {};
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        if (const auto it = m_freeBlocks.find(size); it != m_freeBlocks.end() && !it->second.empty())
+        {
+            auto memory = std::move(it->second.back());
+            it->second.pop_back();
+
+            m_stats.cachedBytes -= size;
+            ++m_stats.hits;
+            return {std::move(memory), size};
+        }
+
+        ++m_stats.misses;
+    }
+
+    // Outside the lock: a fresh allocation may page-fault for a while
+    return {std::make_unique_for_overwrite<std::byte[]>(size), size};
+}
+
+void PGS::BufferPool::release(std::unique_ptr<std::byte[]> memory, const size_t size)
+{
+    std::unique_lock lock(m_mutex);
+
+    // Make room by dropping blocks of other sizes first: after a canvas resize they won't be asked for again
+    std::vector<std::unique_ptr<std::byte[]>> evicted;
+    for (auto it = m_freeBlocks.begin(); it != m_freeBlocks.end() && m_stats.cachedBytes + size > m_maxCachedBytes; )
+    {
+        if (it->first == size)
+        {
+            ++it;
+            continue;
+        }
+
+        m_stats.cachedBytes -= it->first * it->second.size();
+        for (auto& block : it->second)
+            evicted.push_back(std::move(block));
+        it = m_freeBlocks.erase(it);
+    }
+
+    if (m_stats.cachedBytes + size <= m_maxCachedBytes)
+    {
+        m_freeBlocks[size].push_back(std::move(memory));
+        m_stats.cachedBytes += size;
+    }
+
+    lock.unlock();
+    // `evicted` and a block that didn't fit are freed here, outside the lock
+}
+
+void PGS::BufferPool::trim()
+{
+    std::unordered_map<size_t, std::vector<std::unique_ptr<std::byte[]>>> freeBlocks;
+    {
+        std::lock_guard lock(m_mutex);
+        freeBlocks.swap(m_freeBlocks);
+        m_stats.cachedBytes = 0;
+    }
+}
+
+void PGS::BufferPool::setMaxCachedBytes(const size_t maxCachedBytes)
+{
+    std::lock_guard lock(m_mutex);
+    m_maxCachedBytes = maxCachedBytes;
+
+    if (m_stats.cachedBytes > m_maxCachedBytes)
+    {
+        m_freeBlocks.clear();
+        m_stats.cachedBytes = 0;
+    }
+}
+
+PGS::BufferPool::Stats PGS::BufferPool::getStats() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,88 @@
+#include "PGS/core/buffers/color_buffer.h"
+
+#include <algorithm>
+#include <string>
+
+#ifndef NDEBUG
+#include <stdexcept>
+#endif
+
+PGS::ColorBuffer::ColorBuffer(const sf::Vector2u& size)
+    : ColorBuffer(size, Uninitialized)
+{
+    std::fill_n(m_colors, static_cast<size_t>(m_size.x) * m_size.y, FloatColor::Transparent);
+}
+
+PGS::ColorBuffer::ColorBuffer(const sf::Vector2u& size, UninitializedTag)
+    : m_size(size)
+    , m_storage(BufferPool::instance().acquire(static_cast<size_t>(size.x) * size.y * sizeof(FloatColor)))
+    , m_colors(reinterpret_cast<FloatColor*>(m_storage.data()))
+{}
+
+
+void PGS::ColorBuffer::setColor(const sf::Vector2u& pos, const FloatColor& color)
+{
+#ifndef NDEBUG
+    if (pos.x >= m_size.x || pos.y >= m_size.y)
+        throw std::invalid_argument("X must be in [0, " + std::to_string(m_size.x - 1) + "] and " +
+            "Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    m_colors[pos.y * m_size.x + pos.x] = color;
+}
+
+PGS::FloatColor PGS::ColorBuffer::getColor(const sf::Vector2u& pos) const
+{
+#ifndef NDEBUG
+    if (pos.x >= m_size.x || pos.y >= m_size.y)
+        throw std::invalid_argument("X must be in [0, " + std::to_string(m_size.x - 1) + "] and " +
+            "Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    return m_colors[pos.y * m_size.x + pos.x];
+}
+
+void PGS::ColorBuffer::clear(const FloatColor& color)
+{
+    std::fill_n(m_colors, static_cast<size_t>(m_size.x) * m_size.y, color);
+}
+
+std::span<PGS::FloatColor> PGS::ColorBuffer::getRow(const unsigned int y)
+{
+#ifndef NDEBUG
+    if (y >= m_size.y)
+        throw std::invalid_argument("Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    return {m_colors + static_cast<size_t>(y) * m_size.x, m_size.x};
+}
+
+std::span<const PGS::FloatColor> PGS::ColorBuffer::getRow(const unsigned int y) const
+{
+#ifndef NDEBUG
+    if (y >= m_size.y)
+        throw std::invalid_argument("Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    return {m_colors + static_cast<size_t>(y) * m_size.x, m_size.x};
+}
+
+std::span<PGS::FloatColor> PGS::ColorBuffer::getColors()
+{
+    return {m_colors, static_cast<size_t>(m_size.x) * m_size.y};
+}
+
+std::span<const PGS::FloatColor> PGS::ColorBuffer::getColors() const
+{
+    return {m_colors, static_cast<size_t>(m_size.x) * m_size.y};
+}
+
+sf::Vector2u PGS::ColorBuffer::getSize() const
+{
+    return m_size;
+}
+
+const PGS::FloatColor* PGS::ColorBuffer::getData() const
+{
+    return m_colors;
+}
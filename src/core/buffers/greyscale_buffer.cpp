@@ -1,5 +1,6 @@
 #include "PGS/core/buffers/grayscale_buffer.h"
 
+#include <algorithm>
 #include <string>
 
 #ifndef NDEBUG
@@ -7,12 +8,18 @@
 #endif
 
 PGS::GrayscaleBuffer::GrayscaleBuffer(const sf::Vector2u& size)
-    : m_size{size}
+    : GrayscaleBuffer(size, Uninitialized)
 {
-    m_values.resize(m_size.x * m_size.y);
+    std::fill_n(m_values, static_cast<size_t>(m_size.x) * m_size.y, 0.0f);
 }
 
-void PGS::GrayscaleBuffer::setValue(const sf::Vector2u& pos, const uint8_t value)
+PGS::GrayscaleBuffer::GrayscaleBuffer(const sf::Vector2u& size, UninitializedTag)
+    : m_size{size}
+    , m_storage(BufferPool::instance().acquire(static_cast<size_t>(size.x) * size.y * sizeof(float)))
+    , m_values(reinterpret_cast<float*>(m_storage.data()))
+{}
+
+void PGS::GrayscaleBuffer::setValue(const sf::Vector2u& pos, const float value)
 {
 #ifndef NDEBUG
     if (pos.x >= m_size.x || pos.y >= m_size.y)
@@ -25,7 +32,7 @@ void PGS::GrayscaleBuffer::setValue(const sf::Vector2u& pos, const uint8_t value
     m_values[index] = value;
 }
 
-uint8_t PGS::GrayscaleBuffer::getValue(const sf::Vector2u& pos) const
+float PGS::GrayscaleBuffer::getValue(const sf::Vector2u& pos) const
 {
 #ifndef NDEBUG
     if (pos.x >= m_size.x || pos.y >= m_size.y)
@@ -38,12 +45,42 @@ uint8_t PGS::GrayscaleBuffer::getValue(const sf::Vector2u& pos) const
     return m_values[index];
 }
 
+std::span<float> PGS::GrayscaleBuffer::getRow(const unsigned int y)
+{
+#ifndef NDEBUG
+    if (y >= m_size.y)
+        throw std::invalid_argument("Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    return {m_values + static_cast<size_t>(y) * m_size.x, m_size.x};
+}
+
+std::span<const float> PGS::GrayscaleBuffer::getRow(const unsigned int y) const
+{
+#ifndef NDEBUG
+    if (y >= m_size.y)
+        throw std::invalid_argument("Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    return {m_values + static_cast<size_t>(y) * m_size.x, m_size.x};
+}
+
+std::span<float> PGS::GrayscaleBuffer::getValues()
+{
+    return {m_values, static_cast<size_t>(m_size.x) * m_size.y};
+}
+
+std::span<const float> PGS::GrayscaleBuffer::getValues() const
+{
+    return {m_values, static_cast<size_t>(m_size.x) * m_size.y};
+}
+
 sf::Vector2u PGS::GrayscaleBuffer::getSize() const
 {
     return m_size;
 }
 
-const uint8_t* PGS::GrayscaleBuffer::getData() const
+const float* PGS::GrayscaleBuffer::getData() const
 {
-    return m_values.data();
+    return m_values;
 }
@@ -1,17 +1,27 @@
 #include "PGS/core/buffers/pixel_buffer.h"
 
+#include <algorithm>
 #include <string>
 
 #ifndef NDEBUG
 #include <stdexcept>
 #endif
 
+// Pixels are stored as sf::Color, which must stay the plain (r, g, b, a) bytes that getData exposes
+static_assert(sizeof(sf::Color) == 4 && alignof(sf::Color) == 1);
+
 PGS::PixelBuffer::PixelBuffer(const sf::Vector2u& size)
-    : m_size(size)
+    : PixelBuffer(size, Uninitialized)
 {
-    m_pixels.resize(m_size.x * m_size.y * 4); // There are four numbers (r, g, b, a) for each pixel, so we multiply by 4
+    std::fill_n(m_pixels, static_cast<size_t>(m_size.x) * m_size.y, sf::Color::Transparent);
 }
 
+PGS::PixelBuffer::PixelBuffer(const sf::Vector2u& size, UninitializedTag)
+    : m_size(size)
+    , m_storage(BufferPool::instance().acquire(static_cast<size_t>(size.x) * size.y * sizeof(sf::Color)))
+    , m_pixels(reinterpret_cast<sf::Color*>(m_storage.data()))
+{}
+
 
 void PGS::PixelBuffer::setPixel(const sf::Vector2u& pos, const sf::Color& color)
 {
@@ -21,12 +31,7 @@ void PGS::PixelBuffer::setPixel(const sf::Vector2u& pos, const sf::Color& color)
             "Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
 #endif
 
-    const unsigned int index = (pos.y * m_size.x + pos.x) * 4;
-
-    m_pixels[index] = color.r; // Set red color intensity
-    m_pixels[index + 1] = color.g; // Set green color intensity
-    m_pixels[index + 2] = color.b; // Set blue color intensity
-    m_pixels[index + 3] = color.a; // Set alpha intensity
+    m_pixels[pos.y * m_size.x + pos.x] = color;
 }
 
 sf::Color PGS::PixelBuffer::getPixel(const sf::Vector2u& pos) const
@@ -37,25 +42,42 @@ sf::Color PGS::PixelBuffer::getPixel(const sf::Vector2u& pos) const
             "Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
 #endif
 
-    const unsigned int index = (pos.y * m_size.x + pos.x) * 4;
+    return m_pixels[pos.y * m_size.x + pos.x];
+}
+
+void PGS::PixelBuffer::clear(const sf::Color& color)
+{
+    std::fill_n(m_pixels, static_cast<size_t>(m_size.x) * m_size.y, color);
+}
+
+std::span<sf::Color> PGS::PixelBuffer::getRow(const unsigned int y)
+{
+#ifndef NDEBUG
+    if (y >= m_size.y)
+        throw std::invalid_argument("Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    return {m_pixels + static_cast<size_t>(y) * m_size.x, m_size.x};
+}
 
-    return sf::Color{
-        m_pixels[index],
-        m_pixels[index + 1],
-        m_pixels[index + 2],
-        m_pixels[index + 3]
-    };
+std::span<const sf::Color> PGS::PixelBuffer::getRow(const unsigned int y) const
+{
+#ifndef NDEBUG
+    if (y >= m_size.y)
+        throw std::invalid_argument("Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    return {m_pixels + static_cast<size_t>(y) * m_size.x, m_size.x};
 }
 
-void PGS::PixelBuffer::clear(const sf::Color& color) // TODO: This realization doesn't work at Big-endian architecture.
-{                                                    //       Make it portable
-    const uint32_t packedColor = (static_cast<uint32_t>(color.a) << 24) |
-                           (static_cast<uint32_t>(color.b) << 16) |
-                           (static_cast<uint32_t>(color.g) << 8)  |
-                           (static_cast<uint32_t>(color.r));
+std::span<sf::Color> PGS::PixelBuffer::getPixels()
+{
+    return {m_pixels, static_cast<size_t>(m_size.x) * m_size.y};
+}
 
-    auto* pixels32 = reinterpret_cast<uint32_t*>(m_pixels.data());
-    std::fill_n(pixels32, m_size.x * m_size.y, packedColor);
+std::span<const sf::Color> PGS::PixelBuffer::getPixels() const
+{
+    return {m_pixels, static_cast<size_t>(m_size.x) * m_size.y};
 }
 
 sf::Vector2u PGS::PixelBuffer::getSize() const
@@ -65,5 +87,5 @@ sf::Vector2u PGS::PixelBuffer::getSize() const
 
 const uint8_t* PGS::PixelBuffer::getData() const
 {
-    return m_pixels.data();
+    return reinterpret_cast<const uint8_t*>(m_pixels);
 }
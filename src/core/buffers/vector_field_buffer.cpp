@@ -1,17 +1,52 @@
 #include "PGS/core/buffers/vector_field_buffer.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 
 #ifndef NDEBUG
 #include <stdexcept>
 #endif
 
+namespace
+{
+    // Each plane starts on this boundary (one AVX register)
+    constexpr size_t PLANE_ALIGNMENT = 32;
+
+    // Floats per plane: the vector count rounded up, so the Y plane starts on a PLANE_ALIGNMENT boundary too
+    size_t getPlaneStride(const sf::Vector2u& size)
+    {
+        constexpr size_t laneCount = PLANE_ALIGNMENT / sizeof(float);
+
+        const size_t count = static_cast<size_t>(size.x) * size.y;
+        return (count + laneCount - 1) / laneCount * laneCount;
+    }
+
+    float* alignToPlane(std::byte* memory)
+    {
+        constexpr uintptr_t alignment = PLANE_ALIGNMENT;
+
+        const uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+        return reinterpret_cast<float*>((address + alignment - 1) & ~(alignment - 1));
+    }
+}
+
 PGS::VectorFieldBuffer::VectorFieldBuffer(const sf::Vector2u& size)
-    : m_size(size)
+    : VectorFieldBuffer(size, Uninitialized)
 {
-    m_vectors.resize(size.x * size.y);
+    const size_t count = static_cast<size_t>(m_size.x) * m_size.y;
+    std::fill_n(m_xs, count, 0.0f);
+    std::fill_n(m_ys, count, 0.0f);
 }
 
+// The block is over-allocated by one alignment step, so the X plane can start on a PLANE_ALIGNMENT boundary
+PGS::VectorFieldBuffer::VectorFieldBuffer(const sf::Vector2u& size, UninitializedTag)
+    : m_size(size)
+    , m_storage(BufferPool::instance().acquire(2 * getPlaneStride(size) * sizeof(float) + PLANE_ALIGNMENT))
+    , m_xs(alignToPlane(m_storage.data()))
+    , m_ys(m_xs + getPlaneStride(size))
+{}
+
 
 void PGS::VectorFieldBuffer::setVector(const sf::Vector2u& pos, const sf::Vector2f& vec)
 {
@@ -23,7 +58,8 @@ void PGS::VectorFieldBuffer::setVector(const sf::Vector2u& pos, const sf::Vector
 
     const unsigned int index = pos.y * m_size.x + pos.x;
 
-    m_vectors[index] = vec;
+    m_xs[index] = vec.x;
+    m_ys[index] = vec.y;
 }
 
 sf::Vector2f PGS::VectorFieldBuffer::getVector(const sf::Vector2u& pos) const
@@ -36,15 +72,44 @@ sf::Vector2f PGS::VectorFieldBuffer::getVector(const sf::Vector2u& pos) const
 
     const unsigned int index = pos.y * m_size.x + pos.x;
 
-    return m_vectors[index];
+    return {m_xs[index], m_ys[index]};
 }
 
-sf::Vector2u PGS::VectorFieldBuffer::getSize() const
+PGS::VectorFieldBuffer::Span PGS::VectorFieldBuffer::getRow(const unsigned int y)
 {
-    return m_size;
+#ifndef NDEBUG
+    if (y >= m_size.y)
+        throw std::invalid_argument("Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    const size_t offset = static_cast<size_t>(y) * m_size.x;
+    return {{m_xs + offset, m_size.x}, {m_ys + offset, m_size.x}};
 }
 
-const sf::Vector2f* PGS::VectorFieldBuffer::getData() const
+PGS::VectorFieldBuffer::ConstSpan PGS::VectorFieldBuffer::getRow(const unsigned int y) const
 {
-    return m_vectors.data();
+#ifndef NDEBUG
+    if (y >= m_size.y)
+        throw std::invalid_argument("Y must be in [0, " + std::to_string(m_size.y - 1) + "]");
+#endif
+
+    const size_t offset = static_cast<size_t>(y) * m_size.x;
+    return {{m_xs + offset, m_size.x}, {m_ys + offset, m_size.x}};
+}
+
+PGS::VectorFieldBuffer::Span PGS::VectorFieldBuffer::getVectors()
+{
+    const size_t count = static_cast<size_t>(m_size.x) * m_size.y;
+    return {{m_xs, count}, {m_ys, count}};
+}
+
+PGS::VectorFieldBuffer::ConstSpan PGS::VectorFieldBuffer::getVectors() const
+{
+    const size_t count = static_cast<size_t>(m_size.x) * m_size.y;
+    return {{m_xs, count}, {m_ys, count}};
+}
+
+sf::Vector2u PGS::VectorFieldBuffer::getSize() const
+{
+    return m_size;
 }
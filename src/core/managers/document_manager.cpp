@@ -3,8 +3,10 @@
 #include "PGS/core/config.h"
 #include "PGS/gui/ui_context.h"
 
+#include <utility>
+
 PGS::DocumentManager::DocumentManager()
-    : m_pixelBuffer{ std::make_shared<PixelBuffer>(m_canvasConfig.getDefaultSize())}
+    : m_pixelBuffer{ std::make_shared<PixelBuffer>(m_canvasConfig.getDefaultSize(), Uninitialized)}
     , m_canvasView{ m_pixelBuffer }
 {
     m_pixelBuffer->clear(sf::Color::White);
@@ -15,11 +17,17 @@ void PGS::DocumentManager::createNewDocument(sf::Vector2u size, const sf::Color
 {
     if (size.x == 0 || size.y == 0) return;
 
-    const auto newPixelBuffer = std::make_shared<PixelBuffer>(size);
+    const auto newPixelBuffer = std::make_shared<PixelBuffer>(size, Uninitialized);
     newPixelBuffer->clear(color);
 
     m_pixelBuffer = newPixelBuffer;
     m_canvasView.setPixelBuffer(newPixelBuffer); // Reset PixelBuffer
+
+    // The evaluated image was just replaced: request it again even if neither the graph nor the size changed,
+    // and have it published although the output is the same as before
+    m_requestedRevision = 0;
+    m_requestedSize = {};
+    m_republishRequested = true;
 }
 
 std::shared_ptr<PGS::PixelBuffer> PGS::DocumentManager::getPixelBuffer()
@@ -30,9 +38,19 @@ std::shared_ptr<PGS::PixelBuffer> PGS::DocumentManager::getPixelBuffer()
 
 void PGS::DocumentManager::update(sf::Time deltaTime, const Gui::UIContext& context)
 {
-    const auto buffer = context.evaluator.evaluateFinalOutput(m_pixelBuffer->getSize());
+    const auto& evaluator = context.evaluator;
+    const sf::Vector2u size = m_pixelBuffer->getSize();
+
+    if (evaluator.getRevision() != m_requestedRevision || size != m_requestedSize)
+    {
+        m_evaluationService.request(evaluator.createSnapshot(), size, std::exchange(m_republishRequested, false));
+
+        m_requestedRevision = evaluator.getRevision();
+        m_requestedSize = size;
+    }
 
-    if (buffer != nullptr)
+    // A result may still belong to the previous canvas size
+    if (const auto buffer = m_evaluationService.takeResult(); buffer != nullptr && buffer->getSize() == size)
     {
         m_pixelBuffer = buffer;
         m_canvasView.setPixelBuffer(m_pixelBuffer);
@@ -20,12 +20,20 @@ void PGS::Gui::Canvas::setPixelBuffer(std::shared_ptr<PixelBuffer> pixelBuffer)
 	if (!pixelBuffer)
 		throw std::invalid_argument("PixelBuffer is null");
 
+	if (pixelBuffer == m_pixelBuffer)
+		return;
+
 	m_pixelBuffer = std::move(pixelBuffer);
-	m_texture = sf::Texture{m_pixelBuffer->getSize()};
 
-	m_sprite.setTextureRect(sf::IntRect{sf::Vector2i{0, 0},
-		sf::Vector2i{static_cast<int>(m_texture.getSize().x),
-							static_cast<int>(m_texture.getSize().y)}});
+	// Reallocate the texture only when the size changed, otherwise the upload in update() is enough
+	if (m_texture.getSize() != m_pixelBuffer->getSize())
+	{
+		m_texture = sf::Texture{m_pixelBuffer->getSize()};
+
+		m_sprite.setTextureRect(sf::IntRect{sf::Vector2i{0, 0},
+			sf::Vector2i{static_cast<int>(m_texture.getSize().x),
+								static_cast<int>(m_texture.getSize().y)}});
+	}
 
 	markForUpdate();
 }
@@ -0,0 +1,98 @@
+#include "PGS/node_graph/evaluation_service.h"
+
+#include "PGS/core/buffers/pixel_buffer.h"
+
+#include <utility>
+
+PGS::NodeGraph::EvaluationService::EvaluationService()
+    : m_worker{[this](const std::stop_token& stopToken) { workerLoop(stopToken); }}
+{
+}
+
+PGS::NodeGraph::EvaluationService::~EvaluationService()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_currentJobStop.request_stop();
+    }
+
+    m_worker.request_stop();
+}
+
+void PGS::NodeGraph::EvaluationService::request(GraphSnapshot snapshot, const sf::Vector2u bufferSize, const bool republish)
+{
+    {
+        std::lock_guard lock(m_mutex);
+
+        // Generations start at 1, so whatever finishes next counts as new. Later requests don't undo this
+        // before a result was published, even if they cancel the job queued here.
+        if (republish)
+            m_publishedGeneration = 0;
+
+        m_currentJobStop.request_stop();
+        m_currentJobStop = std::stop_source{};
+
+        m_pendingJob = Job{std::move(snapshot), bufferSize, m_currentJobStop.get_token()};
+    }
+
+    m_condition.notify_one();
+}
+
+std::shared_ptr<PGS::PixelBuffer> PGS::NodeGraph::EvaluationService::takeResult()
+{
+    std::lock_guard lock(m_mutex);
+
+    if (m_error)
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+
+    return std::exchange(m_result, nullptr);
+}
+
+// -- Private Methods --
+void PGS::NodeGraph::EvaluationService::workerLoop(const std::stop_token& stopToken)
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock lock(m_mutex);
+            if (!m_condition.wait(lock, stopToken, [this] { return m_pendingJob.has_value(); }))
+                return;
+
+            job = std::move(*m_pendingJob);
+            m_pendingJob.reset();
+        }
+
+        std::shared_ptr<PixelBuffer> result;
+        std::uint64_t generation = 0;
+        std::exception_ptr error;
+
+        try
+        {
+            m_evaluator.applySnapshot(job.snapshot);
+            result = m_evaluator.evaluateFinalOutput(job.bufferSize, job.stopToken);
+            generation = m_evaluator.getOutputGeneration();
+        }
+        catch (const EvaluationCancelled&)
+        {
+            continue;
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        std::lock_guard lock(m_mutex);
+
+        if (job.stopToken.stop_requested())
+            continue;
+
+        if (error)
+            m_error = error;
+        else if (result && generation != m_publishedGeneration)
+        {
+            m_result = std::move(result);
+            m_publishedGeneration = generation;
+        }
+    }
+}
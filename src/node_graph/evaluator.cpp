@@ -2,11 +2,14 @@
 
 // -- PGS Headers --
 #include "PGS/node_graph/helpers.h"
+#include "PGS/core/buffers/color_buffer.h"
 #include "PGS/core/buffers/pixel_buffer.h"
+#include "PGS/core/buffers/vector_field_buffer.h"
 #include "PGS/node_graph/evaluator_observer.h"
 
 // -- Nodes --
 #include "PGS/node_graph/node.h"
+#include "PGS/node_graph/pointwise_node.h"
 //
 #include "PGS/node_graph/nodes/texture_output_node.h"
 //
@@ -33,10 +36,93 @@
 
 // -- STL Headers --
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace
+{
+    const PGS::NodeGraph::PortID OUTPUT_COLOR_PORT{"in_color"};
+
+    // splitmix64 finalizer: every bit of `value` affects every bit of the result
+    std::uint64_t mixBits(std::uint64_t value)
+    {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ull;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebull;
+        value ^= value >> 31;
+        return value;
+    }
+
+    // Order dependent: `value` is mixed on its own, then once more together with everything combined before
+    void hashCombine(PGS::NodeGraph::ResultCache::Key& seed, const std::uint64_t value)
+    {
+        seed = mixBits(seed + 0x9e3779b97f4a7c15ull + mixBits(value));
+    }
+
+    // Uniform data is keyed by its value alone, so equal values share a key wherever they come from
+    std::optional<PGS::NodeGraph::ResultCache::Key> hashUniformData(const PGS::NodeGraph::NodeData& data)
+    {
+        PGS::NodeGraph::ResultCache::Key key = data.index();
+
+        if (const auto* value = std::get_if<float>(&data))
+        {
+            hashCombine(key, std::bit_cast<std::uint32_t>(*value));
+            return key;
+        }
+
+        if (const auto* color = std::get_if<PGS::FloatColor>(&data))
+        {
+            for (const float channel : {color->r, color->g, color->b, color->a})
+                hashCombine(key, std::bit_cast<std::uint32_t>(channel));
+            return key;
+        }
+
+        return std::nullopt;
+    }
+
+    // The data a port of `type` reads from `data`, when getting it takes a pass over a buffer.
+    // Returns nullopt when the port reads `data` as it is; uniform colors and values stay uniform.
+    std::optional<PGS::NodeGraph::NodeData> convertForPort(const PGS::NodeGraph::NodeData& data, const PGS::NodeGraph::DataType type,
+                                                           const sf::Vector2u& bufferSize)
+    {
+        using namespace PGS;
+        using namespace PGS::NodeGraph;
+
+        switch (type)
+        {
+            case DataType::Color:
+                if (const auto* buffer = std::get_if<std::shared_ptr<GrayscaleBuffer>>(&data))
+                    return Converters::toColorBuffer(*buffer);
+                break;
+            case DataType::Grayscale:
+                if (const auto* buffer = std::get_if<std::shared_ptr<ColorBuffer>>(&data))
+                    return Converters::toGrayscale(*buffer);
+                break;
+            case DataType::VectorField:
+                if (!std::holds_alternative<std::shared_ptr<VectorFieldBuffer>>(data))
+                {
+                    if (auto field = convertTo<std::shared_ptr<VectorFieldBuffer>>(data, bufferSize))
+                        return std::move(*field);
+                }
+                break;
+            case DataType::Number:
+                if (const auto* buffer = std::get_if<std::shared_ptr<GrayscaleBuffer>>(&data))
+                    return Converters::toFloat(*buffer);
+                break;
+        }
+
+        return std::nullopt;
+    }
+}
 
 // -- Constructor --
 PGS::NodeGraph::Evaluator::Evaluator()
+    : m_threadCount{std::max(std::thread::hardware_concurrency(), 1u)}
 {
     registerNode<TextureOutputNode>("Texture Output");
 
@@ -70,39 +156,46 @@ PGS::NodeGraph::NodeID PGS::NodeGraph::Evaluator::generateNextNodeID()
     return m_nextNodeID++;
 }
 
-// Propagates the dirty flag recursively through the node graph.
-// NOTE: This function is safe from infinite recursion because:
-// 1. The node graph is guaranteed to be a Directed Acyclic Graph (DAG)
-//    due to cycle checks in `addConnection`.
-// 2. A check for an already-set dirty flag provides a hard stop,
-//    preventing redundant traversal of any branch.
-void PGS::NodeGraph::Evaluator::propagateDirtyFlag(const NodeID nodeId)
+PGS::NodeGraph::NodeID PGS::NodeGraph::Evaluator::createNode(const std::type_index& typeIndex, const NodeID nodeId)
 {
-    auto dirtyFlagIt = m_dirtyFlags.find(nodeId);
+    const auto factory = m_nodeFactories.find(typeIndex);
+    if (factory == m_nodeFactories.end())
+        return INVALID_NODE_ID;
 
-    if (dirtyFlagIt != m_dirtyFlags.end() && dirtyFlagIt->second == true)
-        return;
+    const std::string defaultName = factory->second.name;
 
-    m_dirtyFlags[nodeId] = true;
+    m_nodes[nodeId] = factory->second.factoryFunction(nodeId, defaultName);
 
-    const auto nodeIt = m_nodes.find(nodeId);
-    if (nodeIt == m_nodes.end())
-        return;
+    if (auto* outputNode = dynamic_cast<TextureOutputNode*>(m_nodes[nodeId].get())) {
+        m_outputNodes[nodeId] = outputNode;
+    }
 
-    const auto outputPorts = nodeIt->second->getOutputPorts();
-    for (const auto& outputPort : outputPorts)
-    {
-        OutputPortLocator outputPortLocator{nodeId, outputPort.id};
+    ++m_revision;
+    compilePlan();
 
-        auto connectionIt = m_outputConnections.find(outputPortLocator);
-        if (connectionIt == m_outputConnections.end())
-            continue;
+    notifyNodeAdded(nodeId, *m_nodes[nodeId]);
 
-        for (const auto& connection : connectionIt->second)
-        {
-            propagateDirtyFlag(connection.targetNodeId);
-        }
-    }
+    return nodeId;
+}
+
+// Propagates the dirty flag through the compiled plan.
+// A check for an already-set dirty flag provides a hard stop,
+// preventing redundant traversal of any branch.
+void PGS::NodeGraph::Evaluator::propagateDirtyFlag(const NodeID nodeId)
+{
+    if (const auto planIt = m_planIndices.find(nodeId); planIt != m_planIndices.end())
+        markStepDirty(planIt->second);
+}
+
+void PGS::NodeGraph::Evaluator::markStepDirty(const size_t stepIndex)
+{
+    if (m_dirtySteps[stepIndex])
+        return;
+
+    m_dirtySteps[stepIndex] = true;
+
+    for (const size_t dependent : m_plan[stepIndex].dependents)
+        markStepDirty(dependent);
 }
 
 bool PGS::NodeGraph::Evaluator::checkForCycle(const NodeID sourceNode, const NodeID targetNode)
@@ -126,7 +219,7 @@ bool PGS::NodeGraph::Evaluator::checkForCycle(const NodeID sourceNode, const Nod
     });
 }
 
-PGS::NodeGraph::NodeData PGS::NodeGraph::Evaluator::convertValueToNodeData(const InputPortValue& value, const sf::Vector2u& bufferSize)
+PGS::NodeGraph::NodeData PGS::NodeGraph::Evaluator::convertValueToNodeData(const InputPortValue& value)
 {
     return std::visit([&](auto&& argInput) -> NodeData
     {
@@ -146,9 +239,8 @@ PGS::NodeGraph::NodeData PGS::NodeGraph::Evaluator::convertValueToNodeData(const
         }
         if constexpr (std::is_same_v<T, sf::Color>)
         {
-            auto buffer {std::make_shared<PixelBuffer>(bufferSize)};
-            buffer->clear(argInput);
-            return buffer;
+            // Kept uniform, nodes broadcast it only if they need a buffer
+            return Converters::toFloatColor(argInput);
         }
         if constexpr (std::is_same_v<T, ValueList>)
         {
@@ -160,6 +252,762 @@ PGS::NodeGraph::NodeData PGS::NodeGraph::Evaluator::convertValueToNodeData(const
     }, value);
 }
 
+void PGS::NodeGraph::Evaluator::compilePlan()
+{
+    std::vector<NodeID> nodeIds;
+    nodeIds.reserve(m_nodes.size());
+    for (const auto& [nodeId, node] : m_nodes)
+        nodeIds.push_back(nodeId);
+    std::sort(nodeIds.begin(), nodeIds.end());
+
+    // Post-order DFS over the inputs gives a topological order
+    std::vector<NodeID> order;
+    order.reserve(nodeIds.size());
+    std::unordered_set<NodeID> visited;
+
+    const std::function<void(NodeID)> visit = [&](const NodeID nodeId)
+    {
+        if (!visited.insert(nodeId).second)
+            return;
+
+        for (const auto& inputPort : m_nodes.at(nodeId)->getInputPorts())
+        {
+            if (const auto inputIt = m_inputConnections.find({nodeId, inputPort.id}); inputIt != m_inputConnections.end())
+                visit(inputIt->second.sourceNodeId);
+        }
+
+        order.push_back(nodeId);
+    };
+
+    for (const NodeID nodeId : nodeIds)
+        visit(nodeId);
+
+    std::vector<PlanStep> plan;
+    std::unordered_map<NodeID, size_t> planIndices;
+    std::vector<std::optional<NodeData>> outputSlots;
+    std::vector<std::uint8_t> dirtySteps;
+    std::vector<std::uint8_t> calculatedSlots;
+    std::vector<ResultCache::Key> slotKeys;
+    std::vector<std::shared_ptr<ResultCache::Conversions>> slotConversions;
+
+    plan.reserve(order.size());
+    dirtySteps.reserve(order.size());
+
+    for (const NodeID nodeId : order)
+    {
+        const Node& node = *m_nodes.at(nodeId);
+
+        PlanStep step{
+            .nodeId = nodeId,
+            .node = &node,
+            .pointwise = dynamic_cast<const PointwiseNode*>(&node),
+            .inputs = std::vector<PlanInput>(node.getInputPorts().size()),
+            .firstOutputSlot = outputSlots.size(),
+            .outputCount = node.getOutputPorts().size(),
+            .dependents = {}
+        };
+
+        outputSlots.resize(outputSlots.size() + step.outputCount);
+        calculatedSlots.resize(outputSlots.size(), false);
+        slotKeys.resize(outputSlots.size(), 0);
+        slotConversions.resize(outputSlots.size());
+
+        // Nodes that were already compiled keep their cached outputs and dirty state
+        if (const auto oldIt = m_planIndices.find(nodeId); oldIt != m_planIndices.end())
+        {
+            const PlanStep& oldStep = m_plan[oldIt->second];
+            for (size_t i = 0; i < step.outputCount; ++i)
+            {
+                outputSlots[step.firstOutputSlot + i] = std::move(m_outputSlots[oldStep.firstOutputSlot + i]);
+                calculatedSlots[step.firstOutputSlot + i] = m_calculatedSlots[oldStep.firstOutputSlot + i];
+                slotKeys[step.firstOutputSlot + i] = m_slotKeys[oldStep.firstOutputSlot + i];
+                slotConversions[step.firstOutputSlot + i] = std::move(m_slotConversions[oldStep.firstOutputSlot + i]);
+            }
+
+            dirtySteps.push_back(m_dirtySteps[oldIt->second]);
+        }
+        else
+        {
+            dirtySteps.push_back(true);
+        }
+
+        planIndices[nodeId] = plan.size();
+        plan.push_back(std::move(step));
+    }
+
+    const auto resolveSource = [&](const Connection& connection)
+    {
+        const size_t sourceStep = planIndices.at(connection.sourceNodeId);
+        const auto& outputPorts = plan[sourceStep].node->getOutputPorts();
+
+        const auto portIt = std::find_if(outputPorts.begin(), outputPorts.end(),
+            [&](const OutputPort& port) { return port.id == connection.sourcePortId; });
+
+        return PlanInput{sourceStep, plan[sourceStep].firstOutputSlot + static_cast<size_t>(portIt - outputPorts.begin())};
+    };
+
+    std::vector<std::uint8_t> demandedSlots(outputSlots.size(), false);
+
+    for (size_t stepIndex = 0; stepIndex < plan.size(); ++stepIndex)
+    {
+        auto& step = plan[stepIndex];
+        const auto& inputPorts = step.node->getInputPorts();
+
+        for (size_t i = 0; i < inputPorts.size(); ++i)
+        {
+            const auto inputIt = m_inputConnections.find({step.nodeId, inputPorts[i].id});
+            if (inputIt == m_inputConnections.end())
+                continue;
+
+            step.inputs[i] = resolveSource(inputIt->second);
+            plan[step.inputs[i].sourceStep].dependents.push_back(stepIndex);
+            demandedSlots[step.inputs[i].slot] = true;
+        }
+    }
+
+    m_finalOutput = PlanInput{};
+    for (const auto& [nodeId, outputNodePtr] : m_outputNodes)
+    {
+        if (const auto inputIt = m_inputConnections.find({nodeId, OUTPUT_COLOR_PORT}); inputIt != m_inputConnections.end())
+        {
+            m_finalOutput = resolveSource(inputIt->second);
+            break;
+        }
+    }
+
+    m_plan = std::move(plan);
+    m_planIndices = std::move(planIndices);
+    m_outputSlots = std::move(outputSlots);
+    m_dirtySteps = std::move(dirtySteps);
+    m_demandedSlots = std::move(demandedSlots);
+    m_calculatedSlots = std::move(calculatedSlots);
+    m_slotKeys = std::move(slotKeys);
+    m_slotConversions = std::move(slotConversions);
+}
+
+bool PGS::NodeGraph::Evaluator::hasValidCache(const size_t stepIndex, const sf::Vector2u& bufferSize) const
+{
+    if (m_dirtySteps[stepIndex])
+        return false;
+
+    // Buffers calculated for another size are stale, plain values (float, etc.) stay valid
+    const PlanStep& step = m_plan[stepIndex];
+    for (size_t slot = step.firstOutputSlot; slot < step.firstOutputSlot + step.outputCount; ++slot)
+    {
+        if (!m_outputSlots[slot].has_value())
+            continue;
+
+        const bool sizeMatches = std::visit([&](const auto& data)
+        {
+            using T = std::decay_t<decltype(data)>;
+
+            if constexpr (std::is_same_v<T, float> || std::is_same_v<T, FloatColor>)
+                return true;
+            else
+                return data->getSize() == bufferSize;
+        }, *m_outputSlots[slot]);
+
+        if (!sizeMatches)
+            return false;
+    }
+
+    return true;
+}
+
+std::vector<size_t> PGS::NodeGraph::Evaluator::collectStepsToCalculate(const PlanInput& source, const sf::Vector2u& bufferSize) const
+{
+    // A cached step may still lack the output: it was skipped or fused when nobody read it
+    const auto isCached = [&](const PlanInput& input)
+    {
+        return m_calculatedSlots[input.slot] && hasValidCache(input.sourceStep, bufferSize);
+    };
+
+    if (isCached(source))
+        return {};
+
+    std::vector<size_t> order;
+    std::vector<std::uint8_t> visited(m_plan.size(), false);
+
+    // Post-order DFS: every step is appended after all of its inputs, which keeps the topological order.
+    // Steps with a valid cache end the walk, their upstream subgraph is not needed.
+    // A visited step calculates all of its demanded outputs, which includes every output read here.
+    const std::function<void(const PlanInput&)> visit = [&](const PlanInput& input)
+    {
+        if (visited[input.sourceStep] || isCached(input))
+            return;
+
+        visited[input.sourceStep] = true;
+
+        for (const auto& stepInput : m_plan[input.sourceStep].inputs)
+        {
+            if (stepInput.sourceStep != NO_SLOT)
+                visit(stepInput);
+        }
+
+        order.push_back(input.sourceStep);
+    };
+
+    visit(source);
+
+    return order;
+}
+
+void PGS::NodeGraph::Evaluator::calculateSteps(const std::vector<size_t>& order, const EvaluationContext& context)
+{
+    // Steps stay dirty until they are calculated, so a cancelled evaluation leaves no stale cache behind
+    for (const size_t stepIndex : order)
+        m_dirtySteps[stepIndex] = true;
+
+    // collectStepsToCalculate appends the requested step last
+    const std::vector<Chain> chains = buildChains(order, order.back());
+
+    if (!context.threadPool || chains.size() == 1)
+    {
+        for (const Chain& chain : chains)
+            calculateChain(chain, context);
+        return;
+    }
+
+    struct ChainTask
+    {
+        std::atomic<size_t> pendingInputs{0};
+        std::vector<size_t> dependents;
+    };
+
+    std::vector<size_t> taskIndices(m_plan.size(), NO_SLOT);
+    for (size_t i = 0; i < chains.size(); ++i)
+    {
+        for (const ChainLink& link : chains[i])
+            taskIndices[link.stepIndex] = i;
+    }
+
+    // One counter per chain: the number of connections from other chains whose source is still to be calculated
+    std::vector<ChainTask> tasks(chains.size());
+    for (size_t i = 0; i < chains.size(); ++i)
+    {
+        for (const ChainLink& link : chains[i])
+        {
+            for (const auto& input : m_plan[link.stepIndex].inputs)
+            {
+                if (input.sourceStep == NO_SLOT || taskIndices[input.sourceStep] == NO_SLOT || taskIndices[input.sourceStep] == i)
+                    continue;
+
+                tasks[taskIndices[input.sourceStep]].dependents.push_back(i);
+                tasks[i].pendingInputs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Utils::ThreadPool& threadPool = *context.threadPool;
+    Utils::ThreadPool::TaskGroup group;
+
+    std::function<void(size_t)> schedule = [&](const size_t index)
+    {
+        threadPool.run(group, [&, index]
+        {
+            calculateChain(chains[index], context);
+
+            for (const size_t dependent : tasks[index].dependents)
+            {
+                if (tasks[dependent].pendingInputs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    schedule(dependent);
+            }
+        });
+    };
+
+    // Roots are collected before anything runs: once scheduled, finished tasks bring their dependents'
+    // counters to zero and schedule them themselves, so checking the counters while scheduling would run them twice
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < chains.size(); ++i)
+    {
+        if (tasks[i].pendingInputs.load(std::memory_order_relaxed) == 0)
+            roots.push_back(i);
+    }
+
+    for (const size_t root : roots)
+        schedule(root);
+
+    threadPool.wait(group);
+}
+
+void PGS::NodeGraph::Evaluator::calculateStep(const size_t stepIndex, const EvaluationContext& context)
+{
+    if (context.isCancelled())
+        throw EvaluationCancelled{};
+
+    const PlanStep& step = m_plan[stepIndex];
+
+    const ResultCache::Signature signature = computeStepSignature(stepIndex, context.bufferSize);
+    if (restoreCachedResults(stepIndex, signature))
+        return;
+
+    const NodeInputs inputs = gatherInputs(stepIndex, context);
+
+    // The old results are replaced anyway: releasing them first lets the node reuse their storage from the BufferPool
+    for (size_t slot = step.firstOutputSlot; slot < step.firstOutputSlot + step.outputCount; ++slot)
+        resetSlot(slot);
+
+    const auto& outputPorts = step.node->getOutputPorts();
+
+    std::vector<PortID> demandedOutputs;
+    for (size_t i = 0; i < step.outputCount; ++i)
+    {
+        if (m_demandedSlots[step.firstOutputSlot + i])
+            demandedOutputs.push_back(outputPorts[i].id);
+    }
+
+    EvaluationContext stepContext = context;
+    stepContext.demandedOutputs = demandedOutputs;
+
+    auto results = step.node->calculate(inputs, stepContext);
+
+    // Kernels skip their remaining work when cancelled, so the results may be incomplete
+    if (context.isCancelled())
+        throw EvaluationCancelled{};
+
+    ResultCache::Entry entry;
+    entry.outputs.reserve(step.outputCount);
+    entry.calculated.reserve(step.outputCount);
+    entry.conversions.reserve(step.outputCount);
+
+    for (size_t i = 0; i < step.outputCount; ++i)
+    {
+        const size_t slot = step.firstOutputSlot + i;
+
+        const auto resultIt = std::find_if(results.begin(), results.end(),
+            [&](const auto& result) { return result.first == outputPorts[i].id; });
+
+        m_outputSlots[slot] = resultIt != results.end()
+            ? std::optional<NodeData>{std::move(resultIt->second)}
+            : std::nullopt;
+        m_slotConversions[slot] = std::make_shared<ResultCache::Conversions>(context.bufferSize);
+
+        // A demanded output the node did not return has no result, which is cached like any other
+        m_calculatedSlots[slot] = m_demandedSlots[slot] || resultIt != results.end();
+        m_slotKeys[slot] = computeResultKey(signature.key, i, m_outputSlots[slot]);
+
+        entry.outputs.push_back(m_outputSlots[slot]);
+        entry.calculated.push_back(m_calculatedSlots[slot]);
+        entry.conversions.push_back(m_slotConversions[slot]);
+    }
+
+    m_resultCache.insert(signature, std::move(entry));
+
+    m_dirtySteps[stepIndex] = false;
+}
+
+std::vector<PGS::NodeGraph::Evaluator::Chain> PGS::NodeGraph::Evaluator::buildChains(const std::vector<size_t>& order,
+                                                                                     const size_t targetStep) const
+{
+    std::vector<std::uint8_t> calculated(m_plan.size(), false);
+    for (const size_t stepIndex : order)
+        calculated[stepIndex] = true;
+
+    // Links between a step and the one it is fused into
+    std::vector<size_t> nextLinks(m_plan.size(), NO_SLOT);
+    std::vector<size_t> previousLinks(m_plan.size(), NO_SLOT);
+    std::vector<size_t> chainedInputs(m_plan.size(), NO_SLOT);
+
+    for (const size_t stepIndex : order)
+    {
+        // The output of an inner link is never stored, so nothing but the next link may read it
+        const PlanStep& step = m_plan[stepIndex];
+        if (!step.pointwise || stepIndex == targetStep || step.dependents.size() != 1)
+            continue;
+
+        const size_t dependent = step.dependents.front();
+        const PlanStep& dependentStep = m_plan[dependent];
+        if (!dependentStep.pointwise || !calculated[dependent] || previousLinks[dependent] != NO_SLOT)
+            continue;
+
+        const auto& inputPorts = dependentStep.node->getInputPorts();
+        for (size_t i = 0; i < inputPorts.size(); ++i)
+        {
+            // Kernels pass colors from link to link, a conversion to another type would need a buffer again
+            if (dependentStep.inputs[i].sourceStep == stepIndex && inputPorts[i].type == DataType::Color)
+            {
+                nextLinks[stepIndex] = dependent;
+                previousLinks[dependent] = stepIndex;
+                chainedInputs[dependent] = i;
+            }
+        }
+    }
+
+    // A chain runs in place of its last link: every input from outside the chain is calculated before that one
+    std::vector<Chain> chains;
+    for (const size_t stepIndex : order)
+    {
+        if (nextLinks[stepIndex] != NO_SLOT)
+            continue;
+
+        Chain& chain = chains.emplace_back();
+        for (size_t link = stepIndex; link != NO_SLOT; link = previousLinks[link])
+            chain.push_back({link, chainedInputs[link]});
+
+        std::reverse(chain.begin(), chain.end());
+    }
+
+    return chains;
+}
+
+void PGS::NodeGraph::Evaluator::calculateChain(std::span<const ChainLink> chain, const EvaluationContext& context)
+{
+    while (chain.size() > 1)
+    {
+        if (calculateFusedChain(chain, context))
+            return;
+
+        // A uniform first link needs no buffer: the next link reads its result like any other input
+        calculateStep(chain.front().stepIndex, context);
+        chain = chain.subspan(1);
+    }
+
+    if (!chain.empty())
+        calculateStep(chain.front().stepIndex, context);
+}
+
+bool PGS::NodeGraph::Evaluator::calculateFusedChain(const std::span<const ChainLink> chain, const EvaluationContext& context)
+{
+    if (context.isCancelled())
+        throw EvaluationCancelled{};
+
+    // Inner links get keys like any buffer result, so the whole chain can be found in the cache
+    ResultCache::Signature signature;
+    for (const ChainLink& link : chain)
+    {
+        signature = computeStepSignature(link.stepIndex, context.bufferSize);
+        m_slotKeys[m_plan[link.stepIndex].firstOutputSlot] = computeResultKey(signature.key, 0, std::nullopt);
+    }
+
+    const auto markInnerLinksFused = [&]
+    {
+        for (const ChainLink& link : chain.first(chain.size() - 1))
+        {
+            m_dirtySteps[link.stepIndex] = false;
+            m_calculatedSlots[m_plan[link.stepIndex].firstOutputSlot] = false;
+        }
+    };
+
+    if (restoreCachedResults(chain.back().stepIndex, signature))
+    {
+        markInnerLinksFused();
+        return true;
+    }
+
+    std::vector<PointwiseKernel> kernels;
+    kernels.reserve(chain.size());
+
+    for (size_t i = 0; i < chain.size(); ++i)
+    {
+        const PlanStep& step = m_plan[chain[i].stepIndex];
+
+        // The first link reads all of its inputs itself
+        const size_t chainedInput = i == 0 ? NO_SLOT : chain[i].chainedInput;
+
+        std::optional<PortID> chainedPort;
+        if (chainedInput != NO_SLOT)
+            chainedPort = step.node->getInputPorts()[chainedInput].id;
+
+        auto kernel = step.pointwise->createPointwiseKernel(gatherInputs(chain[i].stepIndex, context, chainedInput), chainedPort, context);
+        if (!kernel)
+            return false;
+
+        kernels.push_back(std::move(kernel));
+    }
+
+    for (const ChainLink& link : chain)
+    {
+        const PlanStep& step = m_plan[link.stepIndex];
+        for (size_t slot = step.firstOutputSlot; slot < step.firstOutputSlot + step.outputCount; ++slot)
+            resetSlot(slot);
+    }
+
+    auto buffer = std::make_shared<ColorBuffer>(context.bufferSize, Uninitialized);
+
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        for (unsigned int y = rowBegin; y < rowEnd; ++y)
+        {
+            const auto row = buffer->getRow(y);
+
+            for (unsigned int xBegin = 0; xBegin < row.size(); xBegin += FUSED_TILE_WIDTH)
+            {
+                const auto tile = row.subspan(xBegin, std::min<size_t>(FUSED_TILE_WIDTH, row.size() - xBegin));
+
+                for (const PointwiseKernel& kernel : kernels)
+                    kernel(y, xBegin, tile);
+            }
+        }
+    });
+
+    if (context.isCancelled())
+        throw EvaluationCancelled{};
+
+    // Pointwise nodes have a single output
+    const size_t tailStep = chain.back().stepIndex;
+    const size_t tailSlot = m_plan[tailStep].firstOutputSlot;
+
+    m_outputSlots[tailSlot] = std::move(buffer);
+    m_slotConversions[tailSlot] = std::make_shared<ResultCache::Conversions>(context.bufferSize);
+    m_calculatedSlots[tailSlot] = true;
+    m_dirtySteps[tailStep] = false;
+
+    m_resultCache.insert(signature, {{m_outputSlots[tailSlot]}, {true}, {m_slotConversions[tailSlot]}});
+
+    markInnerLinksFused();
+
+    return true;
+}
+
+PGS::NodeGraph::NodeInputs PGS::NodeGraph::Evaluator::gatherInputs(const size_t stepIndex, const EvaluationContext& context,
+                                                                   const size_t skippedInput)
+{
+    const PlanStep& step = m_plan[stepIndex];
+    const auto& inputPorts = step.node->getInputPorts();
+
+    NodeInputs inputs{inputPorts};
+
+    for (size_t i = 0; i < inputPorts.size(); ++i)
+    {
+        if (i == skippedInput)
+            continue;
+
+        if (const PlanInput& input = step.inputs[i]; input.slot != NO_SLOT)
+        {
+            // Sources are either calculated before this step or had a valid cache already
+            if (const auto& sourceData = m_outputSlots[input.slot]; sourceData.has_value())
+            {
+                inputs.set(i, getSlotDataAs(input.slot, inputPorts[i].type, context.bufferSize));
+            }
+            else
+            {
+                auto buffer{std::make_shared<ColorBuffer>(context.bufferSize, Uninitialized)};
+                buffer->clear();
+                inputs.set(i, buffer);
+            }
+        }
+        else if (inputPorts[i].value.has_value())
+        {
+            inputs.set(i, convertValueToNodeData(inputPorts[i].value.value()));
+        }
+    }
+
+    return inputs;
+}
+
+PGS::NodeGraph::NodeData PGS::NodeGraph::Evaluator::getSlotDataAs(const size_t slot, const DataType type, const sf::Vector2u& bufferSize)
+{
+    const NodeData& data = *m_outputSlots[slot];
+    ResultCache::Conversions& conversions = *m_slotConversions[slot];
+    assert(conversions.bufferSize == bufferSize);
+
+    // Several consumers of the slot may be gathering their inputs at the same time.
+    // The lock is held only to look up and to publish, so conversions of other slots or types run in parallel.
+    auto& converted = conversions.byType[static_cast<size_t>(type)];
+    {
+        std::lock_guard lock(conversions.mutex);
+        if (converted.has_value())
+            return *converted;
+    }
+
+    auto result = convertForPort(data, type, bufferSize);
+    if (!result.has_value())
+        return data;
+
+    // A consumer that converted at the same time may have published first: everyone shares the first result
+    std::lock_guard lock(conversions.mutex);
+    if (!converted.has_value())
+        converted = std::move(result);
+
+    return *converted;
+}
+
+void PGS::NodeGraph::Evaluator::resetSlot(const size_t slot)
+{
+    m_outputSlots[slot].reset();
+    m_slotConversions[slot].reset();
+}
+
+PGS::NodeGraph::ResultCache::Signature PGS::NodeGraph::Evaluator::computeStepSignature(const size_t stepIndex,
+                                                                                       const sf::Vector2u& bufferSize) const
+{
+    const PlanStep& step = m_plan[stepIndex];
+    const auto& inputPorts = step.node->getInputPorts();
+
+    ResultCache::Signature signature;
+    signature.inputs.reserve(3 + inputPorts.size());
+
+    signature.inputs.push_back(typeid(*step.node).hash_code());
+    signature.inputs.push_back(bufferSize.x);
+    signature.inputs.push_back(bufferSize.y);
+
+    for (size_t i = 0; i < inputPorts.size(); ++i)
+    {
+        if (const PlanInput& input = step.inputs[i]; input.slot != NO_SLOT)
+            signature.inputs.push_back(m_slotKeys[input.slot]);
+        else if (inputPorts[i].value.has_value())
+            signature.inputs.push_back(hashUniformData(convertValueToNodeData(inputPorts[i].value.value())).value());
+        else
+            signature.inputs.push_back(0);
+    }
+
+    for (const ResultCache::Key input : signature.inputs)
+        hashCombine(signature.key, input);
+
+    return signature;
+}
+
+PGS::NodeGraph::ResultCache::Key PGS::NodeGraph::Evaluator::computeResultKey(const ResultCache::Key stepKey, const size_t outputIndex,
+                                                                             const std::optional<NodeData>& result)
+{
+    // Hashing a buffer would cost about as much as many kernels, so it is identified by what produced it
+    if (result.has_value())
+    {
+        if (const auto uniformKey = hashUniformData(*result))
+            return *uniformKey;
+    }
+
+    ResultCache::Key key = stepKey;
+    hashCombine(key, outputIndex + 1);
+    return key;
+}
+
+bool PGS::NodeGraph::Evaluator::restoreCachedResults(const size_t stepIndex, const ResultCache::Signature& signature)
+{
+    const auto entry = m_resultCache.find(signature);
+    if (!entry)
+        return false;
+
+    const PlanStep& step = m_plan[stepIndex];
+    for (size_t i = 0; i < step.outputCount; ++i)
+    {
+        if (m_demandedSlots[step.firstOutputSlot + i] && !entry->calculated[i])
+            return false;
+    }
+
+    for (size_t i = 0; i < step.outputCount; ++i)
+    {
+        const size_t slot = step.firstOutputSlot + i;
+
+        m_outputSlots[slot] = entry->outputs[i];
+        m_slotConversions[slot] = entry->conversions[i];
+        m_calculatedSlots[slot] = entry->calculated[i];
+        m_slotKeys[slot] = computeResultKey(signature.key, i, m_outputSlots[slot]);
+    }
+
+    m_dirtySteps[stepIndex] = false;
+    return true;
+}
+
+PGS::NodeGraph::NodeData PGS::NodeGraph::Evaluator::evaluatePlanInput(const PlanInput& source, const sf::Vector2u& bufferSize,
+                                                                      std::stop_token stopToken)
+{
+    const std::vector<size_t> order = collectStepsToCalculate(source, bufferSize);
+
+    if (!order.empty())
+    {
+        if (!m_threadPool && m_threadCount > 1)
+            m_threadPool = std::make_unique<Utils::ThreadPool>(m_threadCount);
+
+        const EvaluationContext context{
+            .bufferSize = bufferSize,
+            .uvField = getUVField(bufferSize),
+            .demandedOutputs = {}, // Set per step
+            .threadPool = m_threadPool.get(),
+            .stopToken = std::move(stopToken)
+        };
+
+        // Uniform results stay valid across sizes (see hasValidCache), their conversions to buffers don't.
+        // The cache entries keep the old conversions, which match the size in their signature.
+        for (auto& conversions : m_slotConversions)
+        {
+            if (conversions && conversions->bufferSize != bufferSize)
+                conversions = std::make_shared<ResultCache::Conversions>(bufferSize);
+        }
+
+        calculateSteps(order, context);
+
+        trimMemory(source);
+    }
+
+    if (const auto& result = m_outputSlots[source.slot]; result.has_value())
+        return *result;
+
+    // Handling the case when a value is missing in the "results" for some reason
+    auto buffer{std::make_shared<ColorBuffer>(bufferSize, Uninitialized)};
+    buffer->clear();
+
+    return buffer;
+}
+
+void PGS::NodeGraph::Evaluator::trimMemory(const PlanInput& requiredOutput)
+{
+    if (m_resultCache.trim(collectLiveData()))
+        return;
+
+    // Even without cache entries the slots don't fit. Slots are only kept so later evaluations can start from them:
+    // release them, upstream steps first, until the rest fits
+    for (size_t slot = 0; slot < m_outputSlots.size(); ++slot)
+    {
+        if (slot == requiredOutput.slot || slot == m_finalOutput.slot || !m_outputSlots[slot].has_value())
+            continue;
+
+        resetSlot(slot);
+        m_calculatedSlots[slot] = false;
+
+        if (m_resultCache.trim(collectLiveData()))
+            return;
+    }
+}
+
+std::vector<PGS::NodeGraph::NodeData> PGS::NodeGraph::Evaluator::collectLiveData() const
+{
+    std::vector<NodeData> liveData;
+
+    if (m_uvField)
+        liveData.emplace_back(m_uvField);
+
+    for (size_t slot = 0; slot < m_outputSlots.size(); ++slot)
+    {
+        if (m_outputSlots[slot].has_value())
+            liveData.push_back(*m_outputSlots[slot]);
+
+        if (!m_slotConversions[slot])
+            continue;
+
+        std::lock_guard lock(m_slotConversions[slot]->mutex);
+        for (const auto& converted : m_slotConversions[slot]->byType)
+        {
+            if (converted.has_value())
+                liveData.push_back(*converted);
+        }
+    }
+
+    return liveData;
+}
+
+const std::shared_ptr<PGS::VectorFieldBuffer>& PGS::NodeGraph::Evaluator::getUVField(const sf::Vector2u& bufferSize)
+{
+    if (m_uvField && m_uvField->getSize() == bufferSize)
+        return m_uvField;
+
+    // Cached outputs may still hold the old field, so it is replaced rather than overwritten
+    auto uvField = std::make_shared<VectorFieldBuffer>(bufferSize, Uninitialized);
+    for (unsigned int y = 0; y < bufferSize.y; ++y)
+    {
+        const auto row = uvField->getRow(y);
+        const float v = static_cast<float>(y) / static_cast<float>(bufferSize.y);
+        for (unsigned int x = 0; x < bufferSize.x; ++x)
+        {
+            row.x[x] = static_cast<float>(x) / static_cast<float>(bufferSize.x);
+            row.y[x] = v;
+        }
+    }
+
+    m_uvField = std::move(uvField);
+    return m_uvField;
+}
+
 void PGS::NodeGraph::Evaluator::notifyNodeAdded(const NodeID id, const Node& node) const
 {
     for (const auto observer : m_observers)
@@ -196,22 +1044,10 @@ void PGS::NodeGraph::Evaluator::notifyConnectionRemoved(const Connection& connec
 // -- Public Methods --
 PGS::NodeGraph::NodeID PGS::NodeGraph::Evaluator::addNode(const std::type_index& typeIndex)
 {
-    const auto factory = m_nodeFactories.find(typeIndex);
-    if (factory == m_nodeFactories.end())
+    if (!m_nodeFactories.count(typeIndex))
         return INVALID_NODE_ID;
 
-    const NodeID nextId = generateNextNodeID();
-    const std::string defaultName = factory->second.name;
-
-    m_nodes[nextId] = factory->second.factoryFunction(nextId, defaultName);
-
-    if (auto* outputNode = dynamic_cast<TextureOutputNode*>(m_nodes[nextId].get())) {
-        m_outputNodes[nextId] = outputNode;
-    }
-
-    notifyNodeAdded(nextId, *m_nodes[nextId]);
-
-    return nextId;
+    return createNode(typeIndex, generateNextNodeID());
 }
 
 void PGS::NodeGraph::Evaluator::deleteNode(const NodeID& nodeId)
@@ -245,10 +1081,11 @@ void PGS::NodeGraph::Evaluator::deleteNode(const NodeID& nodeId)
 
     notifyNodeRemoved(nodeId);
 
-    m_dirtyFlags.erase(nodeId);
-    m_nodeCaches.erase(nodeId);
     m_nodes.erase(nodeIt);
     m_outputNodes.erase(nodeId);
+
+    ++m_revision;
+    compilePlan();
 }
 
 const std::unordered_map<PGS::NodeGraph::NodeID, std::unique_ptr<PGS::NodeGraph::Node>>& PGS::NodeGraph::Evaluator::getNodes() const
@@ -287,8 +1124,11 @@ void PGS::NodeGraph::Evaluator::addConnection(const Connection& connection)
     m_inputConnections[inputPortLocator] = connection;
     m_outputConnections[outputPortLocator].push_back(connection);
 
+    compilePlan();
+
     // Propagate dirty
     propagateDirtyFlag(connection.targetNodeId);
+    ++m_revision;
 
     notifyConnectionAdded(connection);
 }
@@ -315,9 +1155,12 @@ void PGS::NodeGraph::Evaluator::deleteConnection(const Connection& connection)
     });
     vec.erase(newEnd, vec.end());
 
+    compilePlan();
+
     notifyConnectionRemoved(connection);
 
     propagateDirtyFlag(connection.targetNodeId);
+    ++m_revision;
 }
 
 const std::unordered_map<PGS::NodeGraph::InputPortLocator, PGS::NodeGraph::Connection>& PGS::NodeGraph::Evaluator::getConnections() const
@@ -342,121 +1185,170 @@ void PGS::NodeGraph::Evaluator::removeObserver(EvaluatorObserver* observer)
 }
 
 
-PGS::NodeGraph::NodeData PGS::NodeGraph::Evaluator::evaluate(const NodeID nodeId, const PortID& portId, const sf::Vector2u& bufferSize)
+void PGS::NodeGraph::Evaluator::setThreadCount(const unsigned int threadCount)
+{
+    const unsigned int newThreadCount = threadCount == 0
+        ? std::max(std::thread::hardware_concurrency(), 1u)
+        : threadCount;
+
+    if (newThreadCount == m_threadCount)
+        return;
+
+    m_threadCount = newThreadCount;
+    m_threadPool.reset(); // Recreated lazily with the new size
+}
+
+unsigned int PGS::NodeGraph::Evaluator::getThreadCount() const
+{
+    return m_threadCount;
+}
+
+void PGS::NodeGraph::Evaluator::setResultCacheBudget(const size_t maxBytes)
+{
+    m_resultCache.setMaxBytes(maxBytes);
+    trimMemory(m_finalOutput);
+}
+
+PGS::NodeGraph::ResultCache::Stats PGS::NodeGraph::Evaluator::getResultCacheStats() const
+{
+    return m_resultCache.getStats();
+}
+
+
+std::uint64_t PGS::NodeGraph::Evaluator::getRevision() const
+{
+    return m_revision;
+}
+
+PGS::NodeGraph::GraphSnapshot PGS::NodeGraph::Evaluator::createSnapshot() const
 {
-    // Check for cache
-    if (m_dirtyFlags.count(nodeId) && m_dirtyFlags.at(nodeId) == false)
+    GraphSnapshot snapshot;
+    snapshot.nodes.reserve(m_nodes.size());
+
+    for (const auto& [nodeId, node] : m_nodes)
     {
-        if (auto const nodeCacheIt = m_nodeCaches.find(nodeId); nodeCacheIt != m_nodeCaches.end())
-            if (const auto portCacheIt = nodeCacheIt->second.find(portId); portCacheIt != nodeCacheIt->second.end())
-            {
-                // Check for cache validity
-                NodeData cachedData = portCacheIt->second;
+        auto& nodeState = snapshot.nodes.emplace_back(GraphSnapshot::NodeState{nodeId, typeid(*node), {}});
 
-                if (const auto pixelBuffer = std::get_if<std::shared_ptr<PixelBuffer>>(&cachedData))
-                {
-                    if ((*pixelBuffer)->getSize() == bufferSize)
-                    {
-                        return cachedData;
-                    }
-                }
-                else if (const auto grayscaleBuffer = std::get_if<std::shared_ptr<GrayscaleBuffer>>(&cachedData))
-                {
-                    if ((*grayscaleBuffer)->getSize() == bufferSize)
-                    {
-                        return cachedData;
-                    }
-                }
-                else if (const auto vectorFieldBuffer = std::get_if<std::shared_ptr<VectorFieldBuffer>>(&cachedData))
-                {
-                    if ((*vectorFieldBuffer)->getSize() == bufferSize)
-                    {
-                        return cachedData;
-                    }
-                }
-                else // float, etc.
-                {
-                    return cachedData;
-                }
-            }
+        for (const auto& inputPort : node->getInputPorts())
+        {
+            if (inputPort.value.has_value())
+                nodeState.values.emplace_back(inputPort.id, inputPort.value.value());
+        }
     }
 
-    const auto nodeIt = m_nodes.find(nodeId);
-    assert(nodeIt != m_nodes.end() && ("Failed to find node by id " + std::to_string(nodeId)).c_str());
+    snapshot.connections.reserve(m_inputConnections.size());
+    for (const auto& [locator, connection] : m_inputConnections)
+        snapshot.connections.push_back(connection);
 
-    std::unordered_map<PortID, NodeData> inputs;
+    return snapshot;
+}
 
-    const auto inputPorts = nodeIt->second->getInputPorts();
-    for (const auto& inputPort : inputPorts)
+void PGS::NodeGraph::Evaluator::applySnapshot(const GraphSnapshot& snapshot)
+{
+    std::unordered_map<NodeID, const GraphSnapshot::NodeState*> snapshotNodes;
+    for (const auto& nodeState : snapshot.nodes)
+        snapshotNodes[nodeState.id] = &nodeState;
+
+    // Nodes that are gone or were replaced by another type
+    std::vector<NodeID> staleNodes;
+    for (const auto& [nodeId, node] : m_nodes)
     {
-        auto inputIt = m_inputConnections.find({nodeId, inputPort.id});
-        if (inputIt != m_inputConnections.end())
+        const auto nodeStateIt = snapshotNodes.find(nodeId);
+        if (nodeStateIt == snapshotNodes.end() || nodeStateIt->second->type != std::type_index{typeid(*node)})
+            staleNodes.push_back(nodeId);
+    }
+
+    for (const NodeID nodeId : staleNodes)
+        deleteNode(nodeId);
+
+    for (const auto& nodeState : snapshot.nodes)
+    {
+        if (!m_nodes.count(nodeState.id))
         {
-            inputs[inputPort.id] = evaluate(inputIt->second.sourceNodeId, inputIt->second.sourcePortId, bufferSize);
+            if (createNode(nodeState.type, nodeState.id) == INVALID_NODE_ID)
+                continue;
+
+            m_nextNodeID = std::max(m_nextNodeID, nodeState.id + 1);
         }
-        else
-        {
-            const auto& sourceNode = m_nodes.at(nodeId);
 
-            if (sourceNode->getInputPort(inputPort.id).value.has_value())
-            {
-                inputs[inputPort.id] = convertValueToNodeData(
-                sourceNode->getInputPort(inputPort.id).value.value(),
-                bufferSize);
-            }
+        // Only changed values dirty the node, everything else keeps its cache
+        for (const auto& [portId, value] : nodeState.values)
+        {
+            if (m_nodes.at(nodeState.id)->getInputPort(portId).value != value)
+                setNodeInputPortValue<InputPortValue>(nodeState.id, portId, value);
         }
     }
 
-    auto results = nodeIt->second->calculate(inputs, bufferSize);
+    std::unordered_map<InputPortLocator, Connection> snapshotConnections;
+    for (const auto& connection : snapshot.connections)
+        snapshotConnections[{connection.targetNodeId, connection.targetPortId}] = connection;
 
-    m_nodeCaches[nodeId] = results;
-    m_dirtyFlags[nodeId] = false;
-
-    if (results.count(portId))
+    std::vector<Connection> staleConnections;
+    for (const auto& [locator, connection] : m_inputConnections)
     {
-        return results.at(portId);
+        const auto connectionIt = snapshotConnections.find(locator);
+        if (connectionIt == snapshotConnections.end() || !(connectionIt->second == connection))
+            staleConnections.push_back(connection);
     }
 
-    // Handling the case when a value is missing in the "results" for some reason
-    auto buffer{std::make_shared<PixelBuffer>(bufferSize)};
-    buffer->clear();
+    for (const auto& connection : staleConnections)
+        deleteConnection(connection);
 
-    return buffer;
+    for (const auto& connection : snapshot.connections)
+    {
+        if (!m_inputConnections.count({connection.targetNodeId, connection.targetPortId}))
+            addConnection(connection);
+    }
 }
 
-std::shared_ptr<PGS::PixelBuffer> PGS::NodeGraph::Evaluator::evaluateFinalOutput(const sf::Vector2u& bufferSize)
+
+PGS::NodeGraph::NodeData PGS::NodeGraph::Evaluator::evaluate(const NodeID nodeId, const PortID& portId, const sf::Vector2u& bufferSize,
+                                                             std::stop_token stopToken)
 {
-    Connection const* targetConnection = nullptr;
+    const auto planIt = m_planIndices.find(nodeId);
+    assert(planIt != m_planIndices.end() && ("Failed to find node by id " + std::to_string(nodeId)).c_str());
 
-    for (const auto& [nodeId, outputNodePtr] : m_outputNodes)
-    {
-        const PortID inputPortId = "in_color";
-        InputPortLocator locator{nodeId, inputPortId};
+    const PlanStep& step = m_plan[planIt->second];
+    const auto& outputPorts = step.node->getOutputPorts();
 
-        if (auto it = m_inputConnections.find(locator); it != m_inputConnections.end())
-        {
-            targetConnection = &it->second;
-            break;
-        }
-    }
+    const auto portIt = std::find_if(outputPorts.begin(), outputPorts.end(),
+        [&](const OutputPort& port) { return port.id == portId; });
+    assert(portIt != outputPorts.end() && "Failed to find output port");
+
+    const PlanInput source{planIt->second, step.firstOutputSlot + static_cast<size_t>(portIt - outputPorts.begin())};
+    m_demandedSlots[source.slot] = true;
 
-    if (!targetConnection)
+    return evaluatePlanInput(source, bufferSize, std::move(stopToken));
+}
+
+std::shared_ptr<PGS::PixelBuffer> PGS::NodeGraph::Evaluator::evaluateFinalOutput(const sf::Vector2u& bufferSize, std::stop_token stopToken)
+{
+    if (m_finalOutput.sourceStep == NO_SLOT)
         return nullptr;
 
-    NodeData resultData = evaluate(
-        targetConnection->sourceNodeId,
-        targetConnection->sourcePortId,
-        bufferSize
-    );
+    NodeData resultData = evaluatePlanInput(m_finalOutput, bufferSize, std::move(stopToken));
+
+    if (m_lastOutput && resultData == m_lastOutputSource && m_lastOutput->getSize() == bufferSize)
+        return m_lastOutput;
 
+    // Nodes work in float32, this is the only place where the result is quantized to RGBA8
     auto finalBufferOpt = getConvertedNodeData<std::shared_ptr<PixelBuffer>>(resultData, bufferSize,
         [&](){
-            auto fallbackBuffer = std::make_shared<PixelBuffer>(bufferSize);
+            auto fallbackBuffer = std::make_shared<PixelBuffer>(bufferSize, Uninitialized);
             fallbackBuffer->clear(sf::Color::Black);
 
             return fallbackBuffer;
         }
     );
 
-    return finalBufferOpt.value();
+    m_lastOutputSource = std::move(resultData);
+    m_lastOutput = finalBufferOpt.value();
+    ++m_outputGeneration;
+
+    return m_lastOutput;
+}
+
+std::uint64_t PGS::NodeGraph::Evaluator::getOutputGeneration() const
+{
+    return m_outputGeneration;
 }
@@ -2,81 +2,104 @@
 
 #include "PGS/node_graph/helpers.h"
 
-#include "PGS/core/buffers/pixel_buffer.h"
+#include "PGS/core/buffers/color_buffer.h"
 #include "PGS/core/buffers/grayscale_buffer.h"
 #include "PGS/core/buffers/vector_field_buffer.h"
 
 #include <memory>
 #include <cmath>
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_VECTOR{"in_vector"};
+    const PGS::NodeGraph::PortID IN_COLOR1{"in_color1"};
+    const PGS::NodeGraph::PortID IN_COLOR2{"in_color2"};
+    const PGS::NodeGraph::PortID IN_SCALE{"in_scale"};
+    const PGS::NodeGraph::PortID OUT_COLOR{"out_color"};
+    const PGS::NodeGraph::PortID OUT_GRAYSCALE{"out_grayscale"};
+}
+
 PGS::NodeGraph::CheckerPatternNode::CheckerPatternNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({ "in_vector", "Vector", DataType::VectorField });
+    registerInputPort({ IN_VECTOR, "Vector", DataType::VectorField });
 
-    registerInputPort({ "in_color1", "Color1", DataType::Color, sf::Color::White });
-    registerInputPort({ "in_color2", "Color2", DataType::Color, sf::Color::Black });
+    registerInputPort({ IN_COLOR1, "Color1", DataType::Color, sf::Color::White });
+    registerInputPort({ IN_COLOR2, "Color2", DataType::Color, sf::Color::Black });
 
-    registerInputPort({ "in_scale", "Scale", DataType::Number, 1 });
+    registerInputPort({ IN_SCALE, "Scale", DataType::Number, 1 });
 
     // Output
-    registerOutputPort({ "out_color", "Color", DataType::Color });
-    registerOutputPort({ "out_grayscale", "Grayscale", DataType::Grayscale });
+    registerOutputPort({ OUT_COLOR, "Color", DataType::Color });
+    registerOutputPort({ OUT_GRAYSCALE, "Grayscale", DataType::Grayscale });
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::CheckerPatternNode::calculate(
-    std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::CheckerPatternNode::calculate(
+    const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outColor = std::make_shared<PixelBuffer>(bufferSize);
-    auto outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    auto outColor = std::make_shared<ColorBuffer>(bufferSize, Uninitialized);
+    auto outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize, Uninitialized);
 
     // Getting port values
     std::shared_ptr<VectorFieldBuffer> vectorField = nullptr;
-    if (inputs.find("in_vector") != inputs.end())
-        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, "in_vector", bufferSize);
+    if (inputs.contains(IN_VECTOR))
+        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, IN_VECTOR, bufferSize);
 
-    const auto firstColor = getRequiredInput<std::shared_ptr<PixelBuffer>>(inputs, "in_color1", bufferSize);
-    const auto secondColor = getRequiredInput<std::shared_ptr<PixelBuffer>>(inputs, "in_color2", bufferSize);
-    const auto scale = static_cast<int>(getRequiredInput<float>(inputs, "in_scale", bufferSize));
+    const auto firstColor = getRequiredInput<ColorInput>(inputs, IN_COLOR1, bufferSize);
+    const auto secondColor = getRequiredInput<ColorInput>(inputs, IN_COLOR2, bufferSize);
+    const auto scale = static_cast<int>(getRequiredInput<float>(inputs, IN_SCALE, bufferSize));
 
     // Main algorithm
-    sf::Color finalColor;
-
-    for (unsigned y = 0; y < bufferSize.y; ++y) {
-        for (unsigned x = 0; x < bufferSize.x; ++x)
-        {
-            unsigned distortedX = x;
-            unsigned distortedY = y;
-
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        for (unsigned y = rowBegin; y < rowEnd; ++y) {
+            VectorFieldBuffer::ConstSpan vectorRow;
             if (vectorField != nullptr)
             {
-                const sf::Vector2f vecDistortion = vectorField->getVector({x, y});
-                distortedX += static_cast<int>(vecDistortion.x);
-                distortedY += static_cast<int>(vecDistortion.y);
+                vectorRow = vectorField->getRow(y);
             }
+            const auto firstRow = firstColor.getRow(y);
+            const auto secondRow = secondColor.getRow(y);
+            const auto colorRow = outColor->getRow(y);
+            const auto grayscaleRow = outGrayscale->getRow(y);
 
-            const int cellX = std::floor(static_cast<float>(distortedX) / static_cast<float>(scale));
-            const int cellY = std::floor(static_cast<float>(distortedY) / static_cast<float>(scale));
-
-            if ((cellX + cellY) % 2 == 0)
-            {
-                finalColor = firstColor->getPixel({x, y});
-            }
-            else
+            for (unsigned x = 0; x < bufferSize.x; ++x)
             {
-                finalColor = secondColor->getPixel({x, y});
+                unsigned distortedX = x;
+                unsigned distortedY = y;
+
+                if (vectorField != nullptr)
+                {
+                    const sf::Vector2f vecDistortion = vectorRow[x];
+                    distortedX += static_cast<int>(vecDistortion.x);
+                    distortedY += static_cast<int>(vecDistortion.y);
+                }
+
+                const int cellX = std::floor(static_cast<float>(distortedX) / static_cast<float>(scale));
+                const int cellY = std::floor(static_cast<float>(distortedY) / static_cast<float>(scale));
+
+                FloatColor finalColor;
+                if ((cellX + cellY) % 2 == 0)
+                {
+                    finalColor = firstRow[x];
+                }
+                else
+                {
+                    finalColor = secondRow[x];
+                }
+
+                colorRow[x] = finalColor;
+                grayscaleRow[x] = Converters::toLuminance(finalColor);
             }
-
-            const auto finalGrayscaleValue = static_cast<uint8_t>(0.299 * finalColor.r + 0.587 * finalColor.g + 0.114 * finalColor.b);
-
-            outColor->setPixel({x, y}, finalColor);
-            outGrayscale->setValue({x, y}, finalGrayscaleValue);
         }
-    }
+    });
 
-    std::unordered_map<PortID, NodeData> results;
-    results["out_color"] = std::move(outColor);
-    results["out_grayscale"] = std::move(outGrayscale);
+    NodeOutputs results;
+    results.emplace_back(OUT_COLOR, std::move(outColor));
+    results.emplace_back(OUT_GRAYSCALE, std::move(outGrayscale));
     return results;
 }
\ No newline at end of file
@@ -2,84 +2,106 @@
 
 #include "PGS/node_graph/helpers.h"
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_VECTOR{"in_vector"};
+    const PGS::NodeGraph::PortID IN_COLOR{"in_color"};
+    const PGS::NodeGraph::PortID IN_CENTER_X{"in_center_x"};
+    const PGS::NodeGraph::PortID IN_CENTER_Y{"in_center_y"};
+    const PGS::NodeGraph::PortID IN_RADIUS{"in_radius"};
+    const PGS::NodeGraph::PortID IN_IS_FILLING{"in_is_filling"};
+    const PGS::NodeGraph::PortID OUT_COLOR{"out_color"};
+    const PGS::NodeGraph::PortID OUT_GRAYSCALE{"out_grayscale"};
+}
+
 PGS::NodeGraph::CirclePatternNode::CirclePatternNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({ "in_vector", "Vector", DataType::VectorField });
+    registerInputPort({ IN_VECTOR, "Vector", DataType::VectorField });
 
-    registerInputPort({ "in_color", "Color", DataType::Color, sf::Color::Black });
+    registerInputPort({ IN_COLOR, "Color", DataType::Color, sf::Color::Black });
 
-    registerInputPort({ "in_center_x", "Center X", DataType::Number, 0 });
-    registerInputPort({ "in_center_y", "Center Y", DataType::Number, 0 });
-    registerInputPort({ "in_radius", "Radius", DataType::Number, 0 });
+    registerInputPort({ IN_CENTER_X, "Center X", DataType::Number, 0 });
+    registerInputPort({ IN_CENTER_Y, "Center Y", DataType::Number, 0 });
+    registerInputPort({ IN_RADIUS, "Radius", DataType::Number, 0 });
 
-    registerInputPort({ "in_is_filling", "Filling", DataType::Number, false });
+    registerInputPort({ IN_IS_FILLING, "Filling", DataType::Number, false });
 
     // Output
-    registerOutputPort({ "out_color", "Color", DataType::Color });
-    registerOutputPort({ "out_grayscale", "Grayscale", DataType::Grayscale });
+    registerOutputPort({ OUT_COLOR, "Color", DataType::Color });
+    registerOutputPort({ OUT_GRAYSCALE, "Grayscale", DataType::Grayscale });
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::CirclePatternNode::calculate(
-    std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::CirclePatternNode::calculate(
+    const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outColor = std::make_shared<PixelBuffer>(bufferSize);
-    auto outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    auto outColor = std::make_shared<ColorBuffer>(bufferSize, Uninitialized);
+    auto outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize, Uninitialized);
 
     std::shared_ptr<VectorFieldBuffer> vectorField = nullptr;
-    if (inputs.count("in_vector")) {
-        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, "in_vector", bufferSize);
+    if (inputs.contains(IN_VECTOR)) {
+        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, IN_VECTOR, bufferSize);
     }
 
-    const auto colorBuffer = getRequiredInput<std::shared_ptr<PixelBuffer>>(inputs, "in_color", bufferSize);
-    const auto centerX = getRequiredInput<float>(inputs, "in_center_x", bufferSize);
-    const auto centerY = getRequiredInput<float>(inputs, "in_center_y", bufferSize);
-    const auto radius = getRequiredInput<float>(inputs, "in_radius", bufferSize);
-    const bool isFilling = static_cast<bool>(getRequiredInput<float>(inputs, "in_is_filling", bufferSize));
-
-
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
+    const auto colorInput = getRequiredInput<ColorInput>(inputs, IN_COLOR, bufferSize);
+    const auto centerX = getRequiredInput<float>(inputs, IN_CENTER_X, bufferSize);
+    const auto centerY = getRequiredInput<float>(inputs, IN_CENTER_Y, bufferSize);
+    const auto radius = getRequiredInput<float>(inputs, IN_RADIUS, bufferSize);
+    const bool isFilling = static_cast<bool>(getRequiredInput<float>(inputs, IN_IS_FILLING, bufferSize));
 
-            auto sampleX = static_cast<float>(x);
-            auto sampleY = static_cast<float>(y);
 
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+            VectorFieldBuffer::ConstSpan vectorRow;
             if (vectorField) {
-                sf::Vector2f distortion = vectorField->getVector({x, y});
-                sampleX += distortion.x;
-                sampleY += distortion.y;
+                vectorRow = vectorField->getRow(y);
             }
-
-            const float dx = sampleX - centerX;
-            const float dy = sampleY - centerY;
-            const float distSq = dx * dx + dy * dy;
-
-            bool inside = false;
-            if (isFilling) {
-                inside = distSq <= (radius + 0.5f) * (radius + 0.5f);
-            } else {
-                const float minusHalf = radius - 0.5f;
-                const float plusHalf = radius + 0.5f;
-
-                inside = (distSq >= minusHalf * minusHalf) && (distSq <= plusHalf * plusHalf);
-            }
-
-            if (inside) {
-                sf::Color finalColor = colorBuffer->getPixel({x, y});
-                outColor->setPixel({x, y}, finalColor);
-
-                const float luminance = 0.299f * static_cast<float>(finalColor.r) +
-                                        0.587f * static_cast<float>(finalColor.g) +
-                                        0.114f * static_cast<float>(finalColor.b);
-                outGrayscale->setValue({x, y}, static_cast<uint8_t>(luminance));
-            } else {
-                outColor->setPixel({x, y}, sf::Color::Transparent);
-                outGrayscale->setValue({x, y}, 0);
+            const auto inputRow = colorInput.getRow(y);
+            const auto colorRow = outColor->getRow(y);
+            const auto grayscaleRow = outGrayscale->getRow(y);
+
+            for (unsigned int x = 0; x < bufferSize.x; ++x) {
+
+                auto sampleX = static_cast<float>(x);
+                auto sampleY = static_cast<float>(y);
+
+                if (vectorField) {
+                    sf::Vector2f distortion = vectorRow[x];
+                    sampleX += distortion.x;
+                    sampleY += distortion.y;
+                }
+
+                const float dx = sampleX - centerX;
+                const float dy = sampleY - centerY;
+                const float distSq = dx * dx + dy * dy;
+
+                bool inside = false;
+                if (isFilling) {
+                    inside = distSq <= (radius + 0.5f) * (radius + 0.5f);
+                } else {
+                    const float minusHalf = radius - 0.5f;
+                    const float plusHalf = radius + 0.5f;
+
+                    inside = (distSq >= minusHalf * minusHalf) && (distSq <= plusHalf * plusHalf);
+                }
+
+                if (inside) {
+                    const FloatColor finalColor = inputRow[x];
+                    colorRow[x] = finalColor;
+                    grayscaleRow[x] = Converters::toLuminance(finalColor);
+                } else {
+                    colorRow[x] = FloatColor::Transparent;
+                    grayscaleRow[x] = 0.0f;
+                }
             }
         }
-    }
+    });
 
-    return {{"out_color", std::move(outColor)},
-            {"out_grayscale", std::move(outGrayscale)}};
+    return {{OUT_COLOR, std::move(outColor)},
+            {OUT_GRAYSCALE, std::move(outGrayscale)}};
 }
@@ -5,35 +5,48 @@
 #include "PGS/core/buffers/grayscale_buffer.h"
 #include <algorithm>
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_X{"in_x"};
+    const PGS::NodeGraph::PortID IN_Y{"in_y"};
+    const PGS::NodeGraph::PortID OUT_VECTOR{"out_vector"};
+}
+
 PGS::NodeGraph::CombineXYNode::CombineXYNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({"in_x", "X", DataType::Grayscale, 0.0f});
-    registerInputPort({"in_y", "Y", DataType::Grayscale, 0.0f});
+    registerInputPort({IN_X, "X", DataType::Grayscale, 0.0f});
+    registerInputPort({IN_Y, "Y", DataType::Grayscale, 0.0f});
 
     // Output
-    registerOutputPort({"out_vector", "Vector", DataType::VectorField});
+    registerOutputPort({OUT_VECTOR, "Vector", DataType::VectorField});
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData>
-PGS::NodeGraph::CombineXYNode::calculate(std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs
+PGS::NodeGraph::CombineXYNode::calculate(const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outVector = std::make_shared<VectorFieldBuffer>(bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
 
-    const auto xBuffer = getRequiredInput<std::shared_ptr<GrayscaleBuffer>>(inputs, "in_x", bufferSize);
-    const auto yBuffer = getRequiredInput<std::shared_ptr<GrayscaleBuffer>>(inputs, "in_y", bufferSize);
+    auto outVector = std::make_shared<VectorFieldBuffer>(bufferSize, Uninitialized);
 
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            const sf::Vector2u pos = {x, y};
+    const auto xInput = getRequiredInput<GrayscaleInput>(inputs, IN_X, bufferSize);
+    const auto yInput = getRequiredInput<GrayscaleInput>(inputs, IN_Y, bufferSize);
 
-            const float valueX = static_cast<float>(xBuffer->getValue(pos)) / 255.0f;
-            const float valueY = static_cast<float>(yBuffer->getValue(pos)) / 255.0f;
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+            const auto xRow = xInput.getRow(y);
+            const auto yRow = yInput.getRow(y);
+            const auto outRow = outVector->getRow(y);
 
-            outVector->setVector(pos, {valueX, valueY});
+            for (unsigned int x = 0; x < bufferSize.x; ++x) {
+                outRow.x[x] = xRow[x];
+                outRow.y[x] = yRow[x];
+            }
         }
-    }
+    });
 
-    return {{"out_vector", std::move(outVector)}};
+    return {{OUT_VECTOR, std::move(outVector)}};
 }
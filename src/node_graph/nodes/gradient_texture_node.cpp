@@ -1,6 +1,6 @@
 #include "PGS/node_graph/nodes/gradient_texture_node.h"
 
-#include "PGS/core/buffers/pixel_buffer.h"
+#include "PGS/core/buffers/color_buffer.h"
 #include "PGS/core/buffers/grayscale_buffer.h"
 #include "PGS/node_graph/helpers.h"
 
@@ -8,6 +8,12 @@
 
 namespace
 {
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_VECTOR{"in_vector"};
+    const PGS::NodeGraph::PortID IN_GRADIENT_TYPE{"in_gradient_type"};
+    const PGS::NodeGraph::PortID OUT_COLOR{"out_color"};
+    const PGS::NodeGraph::PortID OUT_GRAYSCALE{"out_grayscale"};
+
     float smoothstep(float t) {
         t = std::clamp(t, 0.0f, 1.0f);
         return t * t * (3.0f - 2.0f * t);
@@ -18,75 +24,96 @@ PGS::NodeGraph::GradientTextureNode::GradientTextureNode(const NodeID id, std::s
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({"in_vector", "Vector", DataType::VectorField});
-    registerInputPort({"in_gradient_type", "Type", DataType::Number,
+    registerInputPort({IN_VECTOR, "Vector", DataType::VectorField});
+    registerInputPort({IN_GRADIENT_TYPE, "Type", DataType::Number,
         ValueList{0, {"Linear", "Quadratic", "Easing", "Radial", "Diagonal"}}});
 
     // Output
-    registerOutputPort({"out_color", "Color", DataType::Color});
-    registerOutputPort({"out_grayscale", "Grayscale", DataType::Grayscale});
+    registerOutputPort({OUT_COLOR, "Color", DataType::Color});
+    registerOutputPort({OUT_GRAYSCALE, "Grayscale", DataType::Grayscale});
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData>
-PGS::NodeGraph::GradientTextureNode::calculate(std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs
+PGS::NodeGraph::GradientTextureNode::calculate(const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outColor = std::make_shared<PixelBuffer>(bufferSize);
-    auto outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    std::shared_ptr<ColorBuffer> outColor;
+    if (context.isOutputDemanded(OUT_COLOR))
+        outColor = std::make_shared<ColorBuffer>(bufferSize, Uninitialized);
 
-    const auto gradientTypeIndex = static_cast<int>(getRequiredInput<float>(inputs, "in_gradient_type", bufferSize));
+    std::shared_ptr<GrayscaleBuffer> outGrayscale;
+    if (context.isOutputDemanded(OUT_GRAYSCALE))
+        outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize, Uninitialized);
+
+    const auto gradientTypeIndex = static_cast<int>(getRequiredInput<float>(inputs, IN_GRADIENT_TYPE, bufferSize));
     const auto gradientType = static_cast<GradientType>(std::clamp(gradientTypeIndex, 0, 4));
 
     std::shared_ptr<VectorFieldBuffer> vectorField = nullptr;
-    if (inputs.count("in_vector")) {
-        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, "in_vector", bufferSize);
+    if (inputs.contains(IN_VECTOR)) {
+        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, IN_VECTOR, bufferSize);
     }
 
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            // Coord distortion
-            sf::Vector2f coord;
-
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+            VectorFieldBuffer::ConstSpan vectorRow;
             if (vectorField) {
-                coord = vectorField->getVector({x, y});
-            } else {
-                coord.x = (bufferSize.x > 1) ? static_cast<float>(x) / static_cast<float>(bufferSize.x - 1) : 0.0f;
-                coord.y = (bufferSize.y > 1) ? static_cast<float>(y) / static_cast<float>(bufferSize.y - 1) : 0.0f;
+                vectorRow = vectorField->getRow(y);
             }
+            const auto grayscaleRow = outGrayscale ? outGrayscale->getRow(y) : std::span<float>{};
+            const auto colorRow = outColor ? outColor->getRow(y) : std::span<FloatColor>{};
+
+            for (unsigned int x = 0; x < bufferSize.x; ++x) {
+                // Coord distortion
+                sf::Vector2f coord;
+
+                if (vectorField) {
+                    coord = vectorRow[x];
+                } else {
+                    coord.x = (bufferSize.x > 1) ? static_cast<float>(x) / static_cast<float>(bufferSize.x - 1) : 0.0f;
+                    coord.y = (bufferSize.y > 1) ? static_cast<float>(y) / static_cast<float>(bufferSize.y - 1) : 0.0f;
+                }
 
-            // Processing gradient type
-            float t = 0.0f;
-            switch (gradientType)
-            {
-                case GradientType::Linear:
-                    t = coord.x;
-                    break;
-                case GradientType::Quadratic:
-                    t = coord.x * coord.x;
-                    break;
-                case GradientType::Easing:
-                    t = smoothstep(coord.x);
-                    break;
-                case GradientType::Radial: {
-                        float dx = coord.x - 0.5f;
-                        float dy = coord.y - 0.5f;
-                        t = std::sqrt(dx * dx + dy * dy) * 2.0f;
+                // Processing gradient type
+                float t = 0.0f;
+                switch (gradientType)
+                {
+                    case GradientType::Linear:
+                        t = coord.x;
+                        break;
+                    case GradientType::Quadratic:
+                        t = coord.x * coord.x;
+                        break;
+                    case GradientType::Easing:
+                        t = smoothstep(coord.x);
+                        break;
+                    case GradientType::Radial: {
+                            float dx = coord.x - 0.5f;
+                            float dy = coord.y - 0.5f;
+                            t = std::sqrt(dx * dx + dy * dy) * 2.0f;
+                            break;
+                    }
+                    case GradientType::Diagonal:
+                        t = (coord.x + coord.y) / 2.0f;
                         break;
                 }
-                case GradientType::Diagonal:
-                    t = (coord.x + coord.y) / 2.0f;
-                    break;
-            }
 
-            t = std::clamp(t, 0.0f, 1.0f);
-            const auto byteValue = static_cast<uint8_t>(t * 255.0f);
+                t = std::clamp(t, 0.0f, 1.0f);
 
-            outGrayscale->setValue({x, y}, byteValue);
-            outColor->setPixel({x, y}, sf::Color(byteValue, byteValue, byteValue));
+                if (outGrayscale)
+                    grayscaleRow[x] = t;
+                if (outColor)
+                    colorRow[x] = Converters::toColor(t);
+            }
         }
-    }
+    });
+
+    NodeOutputs results;
+    if (outColor)
+        results.emplace_back(OUT_COLOR, std::move(outColor));
+    if (outGrayscale)
+        results.emplace_back(OUT_GRAYSCALE, std::move(outGrayscale));
 
-    return {
-        {"out_color", std::move(outColor)},
-        {"out_grayscale", std::move(outGrayscale)}
-    };
+    return results;
 }
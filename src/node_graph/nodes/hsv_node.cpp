@@ -5,43 +5,31 @@
 #include "PGS/node_graph/helpers.h"
 #include "PGS/node_graph/converters.h"
 #include "PGS/node_graph/utils/lerp.h"
+#include "PGS/node_graph/utils/simd.h"
 
-PGS::NodeGraph::HSVNode::HSVNode(const NodeID id, std::string name)
-    : Node(id, std::move(name))
-{
-    // Input
-    registerInputPort({"in_hue", "Hue", DataType::Number, 0.5f});
-    registerInputPort({"in_saturation", "Saturation", DataType::Number, 1.0f});
-    registerInputPort({"in_value", "Value", DataType::Number, 1.0f});
-
-    registerInputPort({"in_fac", "Fac", DataType::Number, 1.0f,
-        Metadata{.description = "Factor of the effect", .minValue = 0.0f, .maxValue = 1.0f}});
-
-    registerInputPort({"in_color", "Color", DataType::Color, sf::Color::White});
+#include <utility>
 
-    // Output
-    registerOutputPort({"out_color", "Color", DataType::Color});
-}
-
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData>
-PGS::NodeGraph::HSVNode::calculate(std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+namespace
 {
-    auto outColor = std::make_shared<PixelBuffer>(bufferSize);
-
-    // Отримуємо вхідні дані
-    const auto hue = getRequiredInput<float>(inputs, "in_hue", bufferSize);
-    const auto saturation = getRequiredInput<float>(inputs, "in_saturation", bufferSize);
-    const auto value = getRequiredInput<float>(inputs, "in_value", bufferSize);
-    const auto factor = getRequiredInput<float>(inputs, "in_fac", bufferSize);
-    const auto colorBuffer = getRequiredInput<std::shared_ptr<PixelBuffer>>(inputs, "in_color", bufferSize);
-
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            const sf::Vector2u pos = {x, y};
-
-            const sf::Color originalColor = colorBuffer->getPixel(pos);
-
-            HSV hsv = Converters::rgbToHsv(originalColor);
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_HUE{"in_hue"};
+    const PGS::NodeGraph::PortID IN_SATURATION{"in_saturation"};
+    const PGS::NodeGraph::PortID IN_VALUE{"in_value"};
+    const PGS::NodeGraph::PortID IN_FAC{"in_fac"};
+    const PGS::NodeGraph::PortID IN_COLOR{"in_color"};
+    const PGS::NodeGraph::PortID OUT_COLOR{"out_color"};
+
+    // The adjustment inputs are single numbers, only the color varies per pixel
+    struct Adjustment
+    {
+        float hue;
+        float saturation;
+        float value;
+        float factor;
+
+        [[nodiscard]] PGS::FloatColor apply(const PGS::FloatColor& originalColor) const
+        {
+            PGS::NodeGraph::HSV hsv = PGS::NodeGraph::Converters::rgbToHsv(originalColor);
 
             hsv.h += hue - 0.5f;
             hsv.h = std::fmod(hsv.h, 1.0f);
@@ -54,16 +42,128 @@ PGS::NodeGraph::HSVNode::calculate(std::unordered_map<PortID, NodeData>& inputs,
             hsv.s = std::clamp(hsv.s, 0.0f, 1.0f);
             hsv.v = std::clamp(hsv.v, 0.0f, 1.0f);
 
-            sf::Color modifiedColor = Converters::hsvToRgb(hsv);
+            PGS::FloatColor modifiedColor = PGS::NodeGraph::Converters::hsvToRgb(hsv);
             modifiedColor.a = originalColor.a;
 
-            sf::Color finalColor = Utils::lerpColor(originalColor, modifiedColor, factor);
+            return PGS::NodeGraph::Utils::lerpColor(originalColor, modifiedColor, factor);
+        }
+
+        // @brief apply() on 4 pixels at once, one register per channel. The results are identical.
+        void apply(PGS::NodeGraph::Utils::Simd::Float4& r, PGS::NodeGraph::Utils::Simd::Float4& g,
+                   PGS::NodeGraph::Utils::Simd::Float4& b, PGS::NodeGraph::Utils::Simd::Float4& a) const
+        {
+            using namespace PGS::NodeGraph::Utils::Simd;
+            namespace Converters = PGS::NodeGraph::Converters;
+
+            const Float4 zero = set1(0.0f), one = set1(1.0f);
+
+            Converters::HSVLanes hsv = Converters::rgbToHsv(r, g, b);
+
+            // std::fmod(h, 1.0f) is exact, and so is h - trunc(h)
+            hsv.h = add(hsv.h, set1(hue - 0.5f));
+            hsv.h = sub(hsv.h, trunc(hsv.h));
+            hsv.h = select(lessThan(hsv.h, zero), add(hsv.h, one), hsv.h);
 
-            outColor->setPixel(pos, finalColor);
+            hsv.s = clamp(mul(hsv.s, set1(saturation)), zero, one);
+            hsv.v = clamp(mul(hsv.v, set1(value)), zero, one);
+
+            Float4 modifiedR, modifiedG, modifiedB;
+            Converters::hsvToRgb(hsv, modifiedR, modifiedG, modifiedB);
+
+            const Float4 keep = set1(1.0f - factor), change = set1(factor);
+            r = add(mul(r, keep), mul(modifiedR, change));
+            g = add(mul(g, keep), mul(modifiedG, change));
+            b = add(mul(b, keep), mul(modifiedB, change));
+            a = add(mul(a, keep), mul(a, change));
+        }
+
+        // @brief Adjusts `count` colors from `source` into `destination`, which may be the same array.
+        void apply(const PGS::FloatColor* source, PGS::FloatColor* destination, const size_t count) const
+        {
+            using namespace PGS::NodeGraph::Utils::Simd;
+
+            size_t i = 0;
+            for (; i + LANES <= count; i += LANES)
+            {
+                Float4 r, g, b, a;
+                loadInterleaved(&source[i].r, r, g, b, a);
+                apply(r, g, b, a);
+                storeInterleaved(&destination[i].r, r, g, b, a);
+            }
+            for (; i < count; ++i)
+                destination[i] = apply(source[i]);
         }
+    };
+
+    Adjustment readAdjustment(const PGS::NodeGraph::NodeInputs& inputs, const sf::Vector2u& bufferSize)
+    {
+        using PGS::NodeGraph::getRequiredInput;
+
+        return {
+            .hue = getRequiredInput<float>(inputs, IN_HUE, bufferSize),
+            .saturation = getRequiredInput<float>(inputs, IN_SATURATION, bufferSize),
+            .value = getRequiredInput<float>(inputs, IN_VALUE, bufferSize),
+            .factor = getRequiredInput<float>(inputs, IN_FAC, bufferSize)
+        };
+    }
+}
+
+PGS::NodeGraph::HSVNode::HSVNode(const NodeID id, std::string name)
+    : PointwiseNode(id, std::move(name))
+{
+    // Input
+    registerInputPort({IN_HUE, "Hue", DataType::Number, 0.5f});
+    registerInputPort({IN_SATURATION, "Saturation", DataType::Number, 1.0f});
+    registerInputPort({IN_VALUE, "Value", DataType::Number, 1.0f});
+
+    registerInputPort({IN_FAC, "Fac", DataType::Number, 1.0f,
+        Metadata{.description = "Factor of the effect", .minValue = 0.0f, .maxValue = 1.0f}});
+
+    registerInputPort({IN_COLOR, "Color", DataType::Color, sf::Color::White});
+
+    // Output
+    registerOutputPort({OUT_COLOR, "Color", DataType::Color});
+}
+
+PGS::NodeGraph::NodeOutputs
+PGS::NodeGraph::HSVNode::calculate(const NodeInputs& inputs, const EvaluationContext& context) const
+{
+    NodeOutputs results;
+
+    if (auto kernel = createPointwiseKernel(inputs, std::nullopt, context)) {
+        results.emplace_back(OUT_COLOR, runKernel(kernel, context));
+        return results;
     }
 
-    std::unordered_map<PortID, NodeData> results;
-    results["out_color"] = std::move(outColor);
+    // A constant color gives a constant result: no buffer at all
+    const auto adjustment = readAdjustment(inputs, context.bufferSize);
+    const auto colorInput = getRequiredInput<ColorInput>(inputs, IN_COLOR, context.bufferSize);
+
+    results.emplace_back(OUT_COLOR, adjustment.apply(colorInput.getColor()));
     return results;
-}
\ No newline at end of file
+}
+
+PGS::NodeGraph::PointwiseKernel PGS::NodeGraph::HSVNode::createPointwiseKernel(const NodeInputs& inputs,
+    const std::optional<PortID>& chainedPort, const EvaluationContext& context) const
+{
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    const auto adjustment = readAdjustment(inputs, bufferSize);
+
+    if (chainedPort == IN_COLOR) {
+        return [=](unsigned int, unsigned int, const std::span<FloatColor> pixels)
+        {
+            adjustment.apply(pixels.data(), pixels.data(), pixels.size());
+        };
+    }
+
+    const auto colorInput = getRequiredInput<ColorInput>(inputs, IN_COLOR, bufferSize);
+    if (colorInput.isUniform())
+        return nullptr;
+
+    return [=, colorBuffer = colorInput.getBuffer()](const unsigned int y, const unsigned int xBegin, const std::span<FloatColor> pixels)
+    {
+        const auto inputRow = std::as_const(*colorBuffer).getRow(y);
+        adjustment.apply(inputRow.data() + xBegin, pixels.data(), pixels.size());
+    };
+}
@@ -3,45 +3,74 @@
 #include "PGS/node_graph/helpers.h"
 #include "PGS/node_graph/utils/lerp.h"
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_FACTOR{"in_factor"};
+    const PGS::NodeGraph::PortID IN_COLOR{"in_color"};
+    const PGS::NodeGraph::PortID OUT_COLOR{"out_color"};
+
+    PGS::FloatColor invertPixel(const PGS::FloatColor& originalColor, const float factorValue)
+    {
+        const float factor = std::clamp(factorValue, 0.0f, 1.0f);
+
+        const PGS::FloatColor invertedColor = {
+            1.0f - originalColor.r,
+            1.0f - originalColor.g,
+            1.0f - originalColor.b,
+            originalColor.a
+        };
+
+        return PGS::NodeGraph::Utils::lerpColor(originalColor, invertedColor, factor);
+    }
+}
+
 PGS::NodeGraph::InvertColorNode::InvertColorNode(const NodeID id, std::string name)
-    : Node(id, std::move(name))
+    : PointwiseNode(id, std::move(name))
 {
     // Input
-    registerInputPort({"in_factor", "Factor", DataType::Grayscale, 0.0f,
+    registerInputPort({IN_FACTOR, "Factor", DataType::Grayscale, 0.0f,
         Metadata{.description = "Factor of the effect", .minValue = 0.0f, .maxValue = 1.0f}});
 
-    registerInputPort({"in_color", "Color", DataType::Color, sf::Color::White});
+    registerInputPort({IN_COLOR, "Color", DataType::Color, sf::Color::White});
 
     // Output
-    registerOutputPort({"out_color", "Color", DataType::Color});
+    registerOutputPort({OUT_COLOR, "Color", DataType::Color});
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::InvertColorNode::calculate(std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::InvertColorNode::calculate(const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outColor = std::make_shared<PixelBuffer>(bufferSize);
+    if (auto kernel = createPointwiseKernel(inputs, std::nullopt, context))
+        return {{OUT_COLOR, runKernel(kernel, context)}};
 
-    const auto factorBuffer = getRequiredInput<std::shared_ptr<GrayscaleBuffer>>(inputs, "in_factor", bufferSize);
-    const auto colorBuffer = getRequiredInput<std::shared_ptr<PixelBuffer>>(inputs, "in_color", bufferSize);
+    // Constant inputs give a constant result: no buffer at all
+    const auto factorInput = getRequiredInput<GrayscaleInput>(inputs, IN_FACTOR, context.bufferSize);
+    const auto colorInput = getRequiredInput<ColorInput>(inputs, IN_COLOR, context.bufferSize);
 
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            const sf::Vector2u pos = {x, y};
+    return {{OUT_COLOR, invertPixel(colorInput.getColor(), factorInput.getUniformValue())}};
+}
 
-            const sf::Color originalColor = colorBuffer->getPixel(pos);
-            const float factor = static_cast<float>(factorBuffer->getValue(pos)) / 255.0f;
+PGS::NodeGraph::PointwiseKernel PGS::NodeGraph::InvertColorNode::createPointwiseKernel(const NodeInputs& inputs,
+    const std::optional<PortID>& chainedPort, const EvaluationContext& context) const
+{
+    const sf::Vector2u& bufferSize = context.bufferSize;
 
-            const sf::Color invertedColor = {
-                static_cast<uint8_t>(255 - originalColor.r),
-                static_cast<uint8_t>(255 - originalColor.g),
-                static_cast<uint8_t>(255 - originalColor.b),
-                originalColor.a
-            };
+    const bool colorChained = chainedPort == IN_COLOR;
 
-            const sf::Color finalColor = Utils::lerpColor(originalColor, invertedColor, factor);
+    const auto factorInput = getRequiredInput<GrayscaleInput>(inputs, IN_FACTOR, bufferSize);
+    const auto colorInput = colorChained ? ColorInput{FloatColor::White} : getRequiredInput<ColorInput>(inputs, IN_COLOR, bufferSize);
 
-            outColor->setPixel(pos, finalColor);
-        }
-    }
+    if (!colorChained && factorInput.isUniform() && colorInput.isUniform())
+        return nullptr;
+
+    return [=](const unsigned int y, const unsigned int xBegin, const std::span<FloatColor> pixels)
+    {
+        const auto factorRow = factorInput.getRow(y);
+        const auto colorRow = colorInput.getRow(y);
 
-    return {{"out_color", std::move(outColor)}};
+        for (unsigned int i = 0; i < pixels.size(); ++i) {
+            const FloatColor color = colorChained ? pixels[i] : colorRow[xBegin + i];
+            pixels[i] = invertPixel(color, factorRow[xBegin + i]);
+        }
+    };
 }
@@ -4,12 +4,21 @@
 
 #include "cmath"
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_ACTION{"in_action"};
+    const PGS::NodeGraph::PortID IN_VALUE1{"in_value1"};
+    const PGS::NodeGraph::PortID IN_VALUE2{"in_value2"};
+    const PGS::NodeGraph::PortID OUT_RESULT{"out_result"};
+}
+
 PGS::NodeGraph::MathNode::MathNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
     registerInputPort({
-        .id = "in_action",
+        .id = IN_ACTION,
         .name = "",
         .type = DataType::Number,
         .value = ValueList{0,
@@ -19,14 +28,14 @@ PGS::NodeGraph::MathNode::MathNode(const NodeID id, std::string name)
     });
 
     registerInputPort({
-        .id = "in_value1",
+        .id = IN_VALUE1,
         .name = "Value1",
         .type = DataType::Number,
         .value = 0.0f
     });
 
     registerInputPort({
-        .id = "in_value2",
+        .id = IN_VALUE2,
         .name = "Value2",
         .type = DataType::Number,
         .value = 0.0f
@@ -34,19 +43,21 @@ PGS::NodeGraph::MathNode::MathNode(const NodeID id, std::string name)
 
     // Output
     registerOutputPort({
-        .id = "out_result",
+        .id = OUT_RESULT,
         .name = "Result",
         .type = DataType::Number
     });
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::MathNode::calculate(
-    std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::MathNode::calculate(
+    const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    const int action = static_cast<int>(getRequiredInput<float>(inputs, "in_action", bufferSize));
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    const int action = static_cast<int>(getRequiredInput<float>(inputs, IN_ACTION, bufferSize));
 
-    const auto value1 = getRequiredInput<float>(inputs, "in_value1", bufferSize);
-    const auto value2 = getRequiredInput<float>(inputs, "in_value2", bufferSize);
+    const auto value1 = getRequiredInput<float>(inputs, IN_VALUE1, bufferSize);
+    const auto value2 = getRequiredInput<float>(inputs, IN_VALUE2, bufferSize);
 
     float result = 0.0f;
 
@@ -86,5 +97,5 @@ std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGr
         result = value1;
     }
 
-    return {{"out_result", result}};
+    return {{OUT_RESULT, result}};
 }
\ No newline at end of file
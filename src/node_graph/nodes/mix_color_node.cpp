@@ -1,131 +1,222 @@
 #include "PGS/node_graph/nodes/mix_color_node.h"
 
 #include "PGS/node_graph/helpers.h"
-#include "PGS/node_graph/utils/lerp.h"
+#include "PGS/node_graph/utils/simd.h"
+
+#include <algorithm>
+#include <type_traits>
 
 // This is a better practice than making helpers private
 namespace
 {
-    sf::Color blendPixel(const sf::Color& base, const sf::Color& blend, const PGS::NodeGraph::MixColorNode::BlendingMode mode)
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_BLENDING_MODE{"in_blending_mode"};
+    const PGS::NodeGraph::PortID IN_FACTOR{"in_factor"};
+    const PGS::NodeGraph::PortID IN_COLOR1{"in_color1"};
+    const PGS::NodeGraph::PortID IN_COLOR2{"in_color2"};
+    const PGS::NodeGraph::PortID OUT_RESULT{"out_result"};
+
+    using BlendingMode = PGS::NodeGraph::MixColorNode::BlendingMode;
+    using PGS::NodeGraph::Utils::Simd::Float4;
+
+    // One pixel per register (lanes r, g, b, a), blended channel by channel. Each mode is a separate
+    // instantiation, so the mode is chosen once per buffer instead of once per pixel.
+    // The result is not clamped: values above 1 (Add, Divide) or below 0 (Subtract) are kept for the following nodes
+    template <BlendingMode Mode>
+    Float4 blendPixel(const Float4 base, const Float4 top)
     {
-        const float baseR = static_cast<float>(base.r) / 255.f;
-        const float baseG = static_cast<float>(base.g) / 255.f;
-        const float baseB = static_cast<float>(base.b) / 255.f;
+        using namespace PGS::NodeGraph::Utils::Simd;
+        using enum PGS::NodeGraph::MixColorNode::BlendingMode;
+
+        const Float4 one = set1(1.f), two = set1(2.f), half = set1(0.5f);
+
+        Float4 result;
+        if constexpr (Mode == Mix)
+            result = top;
+        else if constexpr (Mode == Darken)
+            result = min(base, top);
+        else if constexpr (Mode == Multiply)
+            result = mul(base, top);
+        else if constexpr (Mode == Lighten)
+            result = max(base, top);
+        else if constexpr (Mode == Screen)
+            result = sub(one, mul(sub(one, base), sub(one, top)));
+        else if constexpr (Mode == Add)
+            result = add(base, top);
+        else if constexpr (Mode == Overlay)
+            result = select(lessThan(base, half), mul(mul(two, base), top), sub(one, mul(mul(two, sub(one, base)), sub(one, top))));
+        else if constexpr (Mode == SoftLight)
+            // Negative channels are possible now, sqrt must not turn them into NaN
+            result = select(lessThan(top, half),
+                            add(mul(mul(two, base), top), mul(mul(base, base), sub(one, mul(two, top)))),
+                            add(mul(mul(two, base), sub(one, top)), mul(sqrt(max(base, set1(0.f))), sub(mul(two, top), one))));
+        else if constexpr (Mode == LinearLight)
+            result = select(lessThan(top, half), sub(add(base, mul(two, top)), one), add(base, mul(two, sub(top, half))));
+        else if constexpr (Mode == Difference)
+            result = abs(sub(base, top));
+        else if constexpr (Mode == Exclusion)
+            result = sub(add(base, top), mul(mul(two, base), top));
+        else if constexpr (Mode == Subtract)
+            result = sub(base, top);
+        else if constexpr (Mode == Divide)
+            result = select(equal(top, set1(0.f)), one, div(base, top));
+
+        // The alpha of the base is kept
+        return select(laneMask(false, false, false, true), base, result);
+    }
+
+    template <BlendingMode Mode>
+    Float4 mixPixel(const Float4 base, const Float4 top, const float factorValue)
+    {
+        using namespace PGS::NodeGraph::Utils::Simd;
+
+        const float factor = std::clamp(factorValue, 0.0f, 1.0f);
 
-        const float topR = static_cast<float>(blend.r) / 255.f;
-        const float topG = static_cast<float>(blend.g) / 255.f;
-        const float topB = static_cast<float>(blend.b) / 255.f;
+        // Utils::lerpColor, all channels at once
+        return add(mul(base, set1(1.0f - factor)), mul(blendPixel<Mode>(base, top), set1(factor)));
+    }
+
+    PGS::FloatColor toColor(const Float4 value)
+    {
+        PGS::FloatColor color;
+        PGS::NodeGraph::Utils::Simd::store(&color.r, value);
+        return color;
+    }
 
-        float resultR = 0, resultG = 0, resultB = 0;
+    // @brief Calls `function` with the mode as a compile-time constant.
+    template <typename Function>
+    decltype(auto) withBlendingMode(const BlendingMode mode, Function&& function)
+    {
+        using enum PGS::NodeGraph::MixColorNode::BlendingMode;
 
         switch (mode)
         {
-            case PGS::NodeGraph::MixColorNode::Mix:
-                resultR = topR; resultG = topG; resultB = topB;
-                break;
-            case PGS::NodeGraph::MixColorNode::Darken:
-                resultR = std::min(baseR, topR); resultG = std::min(baseG, topG); resultB = std::min(baseB, topB);
-                break;
-            case PGS::NodeGraph::MixColorNode::Multiply:
-                resultR = baseR * topR; resultG = baseG * topG; resultB = baseB * topB;
-                break;
-            case PGS::NodeGraph::MixColorNode::Lighten:
-                resultR = std::max(baseR, topR); resultG = std::max(baseG, topG); resultB = std::max(baseB, topB);
-                break;
-            case PGS::NodeGraph::MixColorNode::Screen:
-                resultR = 1.f - (1.f - baseR) * (1.f - topR);
-                resultG = 1.f - (1.f - baseG) * (1.f - topG);
-                resultB = 1.f - (1.f - baseB) * (1.f - topB);
-                break;
-            case PGS::NodeGraph::MixColorNode::Add:
-                resultR = baseR + topR; resultG = baseG + topG; resultB = baseB + topB;
-                break;
-            case PGS::NodeGraph::MixColorNode::Overlay:
-                resultR = (baseR < 0.5f) ? (2.f * baseR * topR) : (1.f - 2.f * (1.f - baseR) * (1.f - topR));
-                resultG = (baseG < 0.5f) ? (2.f * baseG * topG) : (1.f - 2.f * (1.f - baseG) * (1.f - topG));
-                resultB = (baseB < 0.5f) ? (2.f * baseB * topB) : (1.f - 2.f * (1.f - baseB) * (1.f - topB));
-                break;
-            case PGS::NodeGraph::MixColorNode::SoftLight:
-                resultR = (topR < 0.5f) ? (2.f * baseR * topR + baseR * baseR * (1.f - 2.f * topR)) : (2.f * baseR * (1.f - topR) + std::sqrt(baseR) * (2.f * topR - 1.f));
-                resultG = (topG < 0.5f) ? (2.f * baseG * topG + baseG * baseG * (1.f - 2.f * topG)) : (2.f * baseG * (1.f - topG) + std::sqrt(baseG) * (2.f * topG - 1.f));
-                resultB = (topB < 0.5f) ? (2.f * baseB * topB + baseB * baseB * (1.f - 2.f * topB)) : (2.f * baseB * (1.f - topB) + std::sqrt(baseB) * (2.f * topB - 1.f));
-                break;
-            case PGS::NodeGraph::MixColorNode::LinearLight:
-                resultR = (topR < 0.5f) ? (baseR + 2.f * topR - 1.f) : (baseR + 2.f * (topR - 0.5f));
-                resultG = (topG < 0.5f) ? (baseG + 2.f * topG - 1.f) : (baseG + 2.f * (topG - 0.5f));
-                resultB = (topB < 0.5f) ? (baseB + 2.f * topB - 1.f) : (baseB + 2.f * (topB - 0.5f));
-                break;
-            case PGS::NodeGraph::MixColorNode::Difference:
-                resultR = std::abs(baseR - topR); resultG = std::abs(baseG - topG); resultB = std::abs(baseB - topB);
-                break;
-            case PGS::NodeGraph::MixColorNode::Exclusion:
-                resultR = baseR + topR - 2.f * baseR * topR;
-                resultG = baseG + topG - 2.f * baseG * topG;
-                resultB = baseB + topB - 2.f * baseB * topB;
-                break;
-            case PGS::NodeGraph::MixColorNode::Subtract:
-                resultR = baseR - topR; resultG = baseG - topG; resultB = baseB - topB;
-                break;
-            case PGS::NodeGraph::MixColorNode::Divide:
-                resultR = (topR == 0) ? 1.f : baseR / topR;
-                resultG = (topG == 0) ? 1.f : baseG / topG;
-                resultB = (topB == 0) ? 1.f : baseB / topB;
-                break;
+            case Mix:         return function(std::integral_constant<BlendingMode, Mix>{});
+            case Darken:      return function(std::integral_constant<BlendingMode, Darken>{});
+            case Multiply:    return function(std::integral_constant<BlendingMode, Multiply>{});
+            case Lighten:     return function(std::integral_constant<BlendingMode, Lighten>{});
+            case Screen:      return function(std::integral_constant<BlendingMode, Screen>{});
+            case Add:         return function(std::integral_constant<BlendingMode, Add>{});
+            case Overlay:     return function(std::integral_constant<BlendingMode, Overlay>{});
+            case SoftLight:   return function(std::integral_constant<BlendingMode, SoftLight>{});
+            case LinearLight: return function(std::integral_constant<BlendingMode, LinearLight>{});
+            case Difference:  return function(std::integral_constant<BlendingMode, Difference>{});
+            case Exclusion:   return function(std::integral_constant<BlendingMode, Exclusion>{});
+            case Subtract:    return function(std::integral_constant<BlendingMode, Subtract>{});
+            case Divide:      break;
         }
 
-        return {
-            static_cast<uint8_t>(std::clamp(resultR, 0.0f, 1.0f) * 255.f),
-            static_cast<uint8_t>(std::clamp(resultG, 0.0f, 1.0f) * 255.f),
-            static_cast<uint8_t>(std::clamp(resultB, 0.0f, 1.0f) * 255.f),
-            base.a
-        };
+        return function(std::integral_constant<BlendingMode, Divide>{});
+    }
+
+    PGS::NodeGraph::MixColorNode::BlendingMode readBlendingMode(const PGS::NodeGraph::NodeInputs& inputs, const sf::Vector2u& bufferSize)
+    {
+        const auto modeIndex = static_cast<int>(PGS::NodeGraph::getRequiredInput<float>(inputs, IN_BLENDING_MODE, bufferSize));
+        return static_cast<PGS::NodeGraph::MixColorNode::BlendingMode>(std::clamp(modeIndex, 0, 12));
     }
 }
 
 PGS::NodeGraph::MixColorNode::MixColorNode(const NodeID id, std::string name)
-    : Node(id, std::move(name))
+    : PointwiseNode(id, std::move(name))
 {
     // Input
-    registerInputPort({"in_blending_mode", "", DataType::Number,
+    registerInputPort({IN_BLENDING_MODE, "", DataType::Number,
         ValueList{0, {"Mix", "Darken", "Multiply", "Lighten", "Screen", "Add", "Overlay", "Soft Light",
             "Linear Light", "Difference", "Exclusion", "Subtract", "Divide"}}});
 
-    registerInputPort({"in_factor", "Factor", DataType::Grayscale, 0.0f,
+    registerInputPort({IN_FACTOR, "Factor", DataType::Grayscale, 0.0f,
         Metadata{.description = "Factor of the effect", .minValue = 0.0f, .maxValue = 1.0f}});
 
-    registerInputPort({"in_color1", "Color1", DataType::Color, sf::Color::White});
-    registerInputPort({"in_color2", "Color2", DataType::Color, sf::Color::Black});
+    registerInputPort({IN_COLOR1, "Color1", DataType::Color, sf::Color::White});
+    registerInputPort({IN_COLOR2, "Color2", DataType::Color, sf::Color::Black});
 
     // Output
-    registerOutputPort({"out_result", "Result", DataType::Color});
+    registerOutputPort({OUT_RESULT, "Result", DataType::Color});
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::MixColorNode::calculate(std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::MixColorNode::calculate(const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outResult = std::make_shared<PixelBuffer>(bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
 
-    const auto modeIndex = static_cast<int>(getRequiredInput<float>(inputs, "in_blending_mode", bufferSize));
-    const auto blendingMode = static_cast<BlendingMode>(std::clamp(modeIndex, 0, 12));
+    const auto factorInput = getRequiredInput<GrayscaleInput>(inputs, IN_FACTOR, bufferSize);
+    const auto color1Input = getRequiredInput<ColorInput>(inputs, IN_COLOR1, bufferSize);
 
-    const auto factorBuffer = getRequiredInput<std::shared_ptr<GrayscaleBuffer>>(inputs, "in_factor", bufferSize);
-    const auto color1Buffer = getRequiredInput<std::shared_ptr<PixelBuffer>>(inputs, "in_color1", bufferSize);
-    const auto color2Buffer = getRequiredInput<std::shared_ptr<PixelBuffer>>(inputs, "in_color2", bufferSize);
+    // Nothing of Color2 is mixed in: the result is Color1 itself, no buffer is written
+    if (factorInput.isUniform() && !(factorInput.getUniformValue() > 0.0f))
+        return {{OUT_RESULT, color1Input.toNodeData()}};
 
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            const sf::Vector2u pos = {x, y};
+    if (auto kernel = createPointwiseKernel(inputs, std::nullopt, context))
+        return {{OUT_RESULT, runKernel(kernel, context)}};
 
-            const sf::Color baseColor = color1Buffer->getPixel(pos);
-            const sf::Color blendColor = color2Buffer->getPixel(pos);
-            const float factor = static_cast<float>(factorBuffer->getValue(pos)) / 255.0f;
+    // Constant inputs give a constant result: no buffer at all
+    const auto color2Input = getRequiredInput<ColorInput>(inputs, IN_COLOR2, bufferSize);
 
-            const sf::Color blendedResult = blendPixel(baseColor, blendColor, blendingMode);
+    const FloatColor color1 = color1Input.getColor();
+    const FloatColor color2 = color2Input.getColor();
+    const FloatColor result = withBlendingMode(readBlendingMode(inputs, bufferSize), [&]<BlendingMode Mode>(std::integral_constant<BlendingMode, Mode>)
+    {
+        return toColor(mixPixel<Mode>(Utils::Simd::load(&color1.r), Utils::Simd::load(&color2.r), factorInput.getUniformValue()));
+    });
 
-            const sf::Color finalColor = Utils::lerpColor(baseColor, blendedResult, factor);
+    return {{OUT_RESULT, result}};
+}
 
-            outResult->setPixel(pos, finalColor);
-        }
+PGS::NodeGraph::PointwiseKernel PGS::NodeGraph::MixColorNode::createPointwiseKernel(const NodeInputs& inputs,
+    const std::optional<PortID>& chainedPort, const EvaluationContext& context) const
+{
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    const auto blendingMode = readBlendingMode(inputs, bufferSize);
+
+    const bool color1Chained = chainedPort == IN_COLOR1;
+    const bool color2Chained = chainedPort == IN_COLOR2;
+
+    const auto factorInput = getRequiredInput<GrayscaleInput>(inputs, IN_FACTOR, bufferSize);
+    const auto color1Input = color1Chained ? ColorInput{FloatColor::White} : getRequiredInput<ColorInput>(inputs, IN_COLOR1, bufferSize);
+    const auto color2Input = color2Chained ? ColorInput{FloatColor::Black} : getRequiredInput<ColorInput>(inputs, IN_COLOR2, bufferSize);
+
+    if (!chainedPort && factorInput.isUniform() && color1Input.isUniform() && color2Input.isUniform())
+        return nullptr;
+
+    // A uniform factor of 0 or 1 needs no lerp: the result is Color1, or the blend of both
+    const bool uniformFactor = factorInput.isUniform();
+    const float factor = std::clamp(factorInput.getUniformValue(), 0.0f, 1.0f);
+
+    if (uniformFactor && !(factor > 0.0f))
+    {
+        return [=](const unsigned int y, const unsigned int xBegin, const std::span<FloatColor> pixels)
+        {
+            if (color1Chained)
+                return;
+
+            const auto color1Row = color1Input.getRow(y);
+            for (unsigned int i = 0; i < pixels.size(); ++i)
+                pixels[i] = color1Row[xBegin + i];
+        };
     }
 
-    return {{"out_result", std::move(outResult)}};
+    return withBlendingMode(blendingMode, [&]<BlendingMode Mode>(std::integral_constant<BlendingMode, Mode>) -> PointwiseKernel
+    {
+        const bool fullFactor = uniformFactor && factor == 1.0f;
+
+        return [=](const unsigned int y, const unsigned int xBegin, const std::span<FloatColor> pixels)
+        {
+            const auto factorRow = factorInput.getRow(y);
+            const auto color1Row = color1Input.getRow(y);
+            const auto color2Row = color2Input.getRow(y);
+
+            auto* channels = reinterpret_cast<float*>(pixels.data());
+
+            for (unsigned int i = 0; i < pixels.size(); ++i)
+            {
+                const FloatColor color1 = color1Chained ? pixels[i] : color1Row[xBegin + i];
+                const FloatColor color2 = color2Chained ? pixels[i] : color2Row[xBegin + i];
+
+                const Float4 base = Utils::Simd::load(&color1.r);
+                const Float4 top = Utils::Simd::load(&color2.r);
+
+                Utils::Simd::store(channels + i * 4, fullFactor ? blendPixel<Mode>(base, top) : mixPixel<Mode>(base, top, factorRow[xBegin + i]));
+            }
+        };
+    });
 }
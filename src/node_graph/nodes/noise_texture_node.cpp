@@ -3,110 +3,212 @@
 #include "PGS/node_graph/helpers.h"
 #include "PGS/node_graph/converters.h"
 #include "PGS/node_graph/utils/perlin_noise_2d.h"
+#include "PGS/node_graph/utils/value_range.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_NORMALIZE{"in_normalize"};
+    const PGS::NodeGraph::PortID IN_VECTOR{"in_vector"};
+    const PGS::NodeGraph::PortID IN_SCALE{"in_scale"};
+    const PGS::NodeGraph::PortID IN_DETAIL{"in_detail"};
+    const PGS::NodeGraph::PortID IN_ROUGHNESS{"in_roughness"};
+    const PGS::NodeGraph::PortID IN_LACUNARITY{"in_lacunarity"};
+    const PGS::NodeGraph::PortID IN_DISTORTION{"in_distortion"};
+    const PGS::NodeGraph::PortID IN_SEED{"in_seed"};
+    const PGS::NodeGraph::PortID OUT_GRAYSCALE{"out_grayscale"};
+    const PGS::NodeGraph::PortID OUT_COLOR{"out_color"};
+}
 
 PGS::NodeGraph::NoiseTextureNode::NoiseTextureNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({ "in_normalize", "Normalize", DataType::Number, true });
+    registerInputPort({ IN_NORMALIZE, "Normalize", DataType::Number, true });
 
-    registerInputPort({ "in_vector", "Vector", DataType::VectorField });
+    registerInputPort({ IN_VECTOR, "Vector", DataType::VectorField });
 
-    registerInputPort({ "in_scale", "Scale", DataType::Number, 5.0f });
-    registerInputPort({ "in_detail", "Detail", DataType::Number, 2.0f });
+    registerInputPort({ IN_SCALE, "Scale", DataType::Number, 5.0f });
+    registerInputPort({ IN_DETAIL, "Detail", DataType::Number, 2.0f });
 
-    registerInputPort({ "in_roughness", "Roughness", DataType::Number, 0.5f,
+    registerInputPort({ IN_ROUGHNESS, "Roughness", DataType::Number, 0.5f,
         Metadata{.description = "Roughness of the effect", .minValue = 0.0f, .maxValue = 1.0f}});
 
-    registerInputPort({ "in_lacunarity", "Lacunarity", DataType::Number, 2.0f });
-    registerInputPort({ "in_distortion", "Distortion", DataType::Number, 0.0f });
+    registerInputPort({ IN_LACUNARITY, "Lacunarity", DataType::Number, 2.0f });
+    registerInputPort({ IN_DISTORTION, "Distortion", DataType::Number, 0.0f });
+    registerInputPort({ IN_SEED, "Seed", DataType::Number, 0 });
 
     // Output
-    registerOutputPort({ "out_grayscale", "Grayscale", DataType::Grayscale });
-    registerOutputPort({ "out_color", "Color", DataType::Color });
+    registerOutputPort({ OUT_GRAYSCALE, "Grayscale", DataType::Grayscale });
+    registerOutputPort({ OUT_COLOR, "Color", DataType::Color });
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::NoiseTextureNode::calculate(
-    std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::NoiseTextureNode::calculate(
+    const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize);
-    auto outColor = std::make_shared<PixelBuffer>(bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
 
     std::shared_ptr<VectorFieldBuffer> vectorField = nullptr;
-    if (inputs.count("in_vector")) {
-        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, "in_vector", bufferSize);
+    if (inputs.contains(IN_VECTOR)) {
+        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, IN_VECTOR, bufferSize);
     }
 
-    const bool isNormalize     = static_cast<bool>(getRequiredInput<float>(inputs, "in_normalize", bufferSize));
-    const auto scale      = getRequiredInput<float>(inputs, "in_scale", bufferSize);
-    const auto detail     = getRequiredInput<float>(inputs, "in_detail", bufferSize);
-    const auto roughness  = getRequiredInput<float>(inputs, "in_roughness", bufferSize);
-    const auto lacunarity = getRequiredInput<float>(inputs, "in_lacunarity", bufferSize);
-    const auto distortion = getRequiredInput<float>(inputs, "in_distortion", bufferSize);
-
-    std::vector<float> rawNoise(bufferSize.x * bufferSize.y);
-
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            Utils::PerlinNoise2D perlin;
-
-            sf::Vector2f coord = {
-                static_cast<float>(x) / static_cast<float>(bufferSize.x),
-                static_cast<float>(y) / static_cast<float>(bufferSize.y)
-            };
+    const bool isNormalize     = static_cast<bool>(getRequiredInput<float>(inputs, IN_NORMALIZE, bufferSize));
+    const auto scale      = getRequiredInput<float>(inputs, IN_SCALE, bufferSize);
+    const auto detail     = getRequiredInput<float>(inputs, IN_DETAIL, bufferSize);
+    const auto roughness  = getRequiredInput<float>(inputs, IN_ROUGHNESS, bufferSize);
+    const auto lacunarity = getRequiredInput<float>(inputs, IN_LACUNARITY, bufferSize);
+    const auto distortion = getRequiredInput<float>(inputs, IN_DISTORTION, bufferSize);
+    const auto seed       = static_cast<unsigned int>(static_cast<int>(getRequiredInput<float>(inputs, IN_SEED, bufferSize)));
+
+    // One generator for the whole buffer; it only reads the shared permutation table
+    const Utils::PerlinNoise2D perlin{seed};
+
+    const int intDetail = static_cast<int>(std::floor(detail));
+    const float fracDetail = detail - static_cast<float>(intDetail);
+
+    // The raw noise is written straight into the grayscale buffer and normalized in place. When only the
+    // color output is used the buffer is scratch, and its memory goes back to the BufferPool for the next evaluation.
+    auto values = std::make_shared<GrayscaleBuffer>(bufferSize, Uninitialized);
+    Utils::ConcurrentValueRange valueRange;
+
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        const unsigned int width = bufferSize.x;
+
+        // Row scratch: every octave is sampled for a whole row at once through the batch (SIMD) API.
+        // Kept per thread, so bands and evaluations reuse it instead of allocating their own.
+        thread_local std::vector<float> rowScratch;
+        rowScratch.resize(static_cast<size_t>(width) * 5);
+
+        const std::span<float> coordX{rowScratch.data(), width};
+        const std::span<float> coordY{rowScratch.data() + width, width};
+        const std::span<float> sampleX{rowScratch.data() + width * 2, width};
+        const std::span<float> sampleY{rowScratch.data() + width * 3, width};
+        const std::span<float> noise{rowScratch.data() + width * 4, width};
+
+        // The range is reduced per band while its rows are still in the cache
+        Utils::ValueRange bandRange;
+
+        const auto sampleRow = [&](const float frequency) {
+            for (unsigned int x = 0; x < width; ++x) {
+                sampleX[x] = coordX[x] * frequency;
+                sampleY[x] = coordY[x] * frequency;
+            }
+            perlin.getValues(sampleX.data(), sampleY.data(), noise.data(), width);
+        };
 
+        for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+            // The planes are added component-wise, which vectorizes
+            const auto uvRow = std::as_const(*context.uvField).getRow(y);
             if (vectorField) {
-                coord += vectorField->getVector({x, y});
+                const auto vectorRow = std::as_const(*vectorField).getRow(y);
+                for (unsigned int x = 0; x < width; ++x) {
+                    coordX[x] = uvRow.x[x] + vectorRow.x[x];
+                    coordY[x] = uvRow.y[x] + vectorRow.y[x];
+                }
+            } else {
+                std::ranges::copy(uvRow.x, coordX.begin());
+                std::ranges::copy(uvRow.y, coordY.begin());
             }
 
-            coord += distortion * perlin.getValue(coord * 4.0f) * sf::Vector2f{1.f, 1.f};
+            // Zero distortion would only add zeros
+            if (distortion != 0.f) {
+                sampleRow(4.0f);
+                for (unsigned int x = 0; x < width; ++x) {
+                    const float offset = distortion * noise[x];
+                    coordX[x] += offset;
+                    coordY[x] += offset;
+                }
+            }
+
+            const auto valueRow = values->getRow(y);
+            float* value = valueRow.data();
+            std::fill_n(value, width, 0.0f);
 
             float amplitude = 1.0f;
             float frequency = scale;
-            float value = 0.0f;
-
-            const int intDetail = static_cast<int>(std::floor(detail));
-            const float fracDetail = detail - static_cast<float>(intDetail);
 
             for (int octave = 0; octave < intDetail; ++octave) {
-                value += amplitude * perlin.getValue(coord * frequency);
+                sampleRow(frequency);
+                for (unsigned int x = 0; x < width; ++x) {
+                    value[x] += amplitude * noise[x];
+                }
                 frequency *= lacunarity;
                 amplitude *= roughness;
             }
 
             if (fracDetail > 0.f) {
-                value += fracDetail * amplitude * perlin.getValue(coord * frequency);
+                sampleRow(frequency);
+                const float weight = fracDetail * amplitude;
+                for (unsigned int x = 0; x < width; ++x) {
+                    value[x] += weight * noise[x];
+                }
             }
 
-            rawNoise[y * bufferSize.x + x] = value;
+            if (isNormalize) {
+                bandRange.include(valueRow);
+            }
         }
-    }
+
+        valueRange.merge(bandRange);
+    });
 
     // Normalizing
-    const float minVal = *std::min_element(rawNoise.begin(), rawNoise.end());
-    const float maxVal = *std::max_element(rawNoise.begin(), rawNoise.end());
-    float range = maxVal - minVal;
+    const Utils::ValueRange noiseRange = valueRange.get();
+    const float minVal = noiseRange.min;
+    float range = noiseRange.max - noiseRange.min;
     if (range < 1e-7f) range = 1.0f;
 
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            float val = rawNoise[y * bufferSize.x + x];
-            if (isNormalize) {
-                val = (val - minVal) / range;
-            } else {
-                val = std::max(0.0f, val);
+    // The colorization (an HSV conversion per pixel) is skipped when only the grayscale output is used
+    std::shared_ptr<ColorBuffer> outColor;
+    if (context.isOutputDemanded(OUT_COLOR))
+        outColor = std::make_shared<ColorBuffer>(bufferSize, Uninitialized);
+
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+            float* value = values->getRow(y).data();
+
+            for (unsigned int x = 0; x < bufferSize.x; ++x) {
+                float val = value[x];
+                if (isNormalize) {
+                    val = (val - minVal) / range;
+                } else {
+                    val = std::max(0.0f, val);
+                }
+
+                value[x] = std::clamp(val, 0.0f, 1.0f);
             }
 
-            val = std::clamp(val, 0.0f, 1.0f);
-            const auto grayValue = static_cast<uint8_t>(val * 255);
-
-            outGrayscale->setValue({x, y}, grayValue);
-
-            sf::Color color = Converters::hsvToRgb({val, 1.0f, 1.0f});
-            outColor->setPixel({x, y}, color);
+            if (outColor) {
+                using namespace Utils::Simd;
+
+                // The hue ramp of hsvToRgb({value, 1, 1}), 4 pixels at a time
+                const Float4 one = set1(1.0f);
+                const auto colorRow = outColor->getRow(y);
+
+                unsigned int x = 0;
+                for (; x + LANES <= bufferSize.x; x += LANES) {
+                    Float4 r, g, b;
+                    Converters::hsvToRgb({load(value + x), one, one}, r, g, b);
+                    storeInterleaved(&colorRow[x].r, r, g, b, one);
+                }
+                for (; x < bufferSize.x; ++x) {
+                    colorRow[x] = Converters::hsvToRgb({value[x], 1.0f, 1.0f});
+                }
+            }
         }
-    }
+    });
+
+    NodeOutputs results;
+    if (outColor)
+        results.emplace_back(OUT_COLOR, std::move(outColor));
+    if (context.isOutputDemanded(OUT_GRAYSCALE))
+        results.emplace_back(OUT_GRAYSCALE, std::move(values));
 
-    return {{"out_color", std::move(outColor)},
-            {"out_grayscale", std::move(outGrayscale)}};
-}
\ No newline at end of file
+    return results;
+}
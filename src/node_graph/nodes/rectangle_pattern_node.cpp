@@ -2,84 +2,107 @@
 
 #include "PGS/node_graph/helpers.h"
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_VECTOR{"in_vector"};
+    const PGS::NodeGraph::PortID IN_COLOR{"in_color"};
+    const PGS::NodeGraph::PortID IN_X{"in_x"};
+    const PGS::NodeGraph::PortID IN_Y{"in_y"};
+    const PGS::NodeGraph::PortID IN_SIZE_X{"in_size_x"};
+    const PGS::NodeGraph::PortID IN_SIZE_Y{"in_size_y"};
+    const PGS::NodeGraph::PortID IN_IS_FILLING{"in_is_filling"};
+    const PGS::NodeGraph::PortID OUT_COLOR{"out_color"};
+    const PGS::NodeGraph::PortID OUT_GRAYSCALE{"out_grayscale"};
+}
+
 PGS::NodeGraph::RectanglePatternNode::RectanglePatternNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({ "in_vector", "Vector", DataType::VectorField });
+    registerInputPort({ IN_VECTOR, "Vector", DataType::VectorField });
 
-    registerInputPort({ "in_color", "Color", DataType::Color, sf::Color::Black });
+    registerInputPort({ IN_COLOR, "Color", DataType::Color, sf::Color::Black });
 
-    registerInputPort({ "in_x", "X", DataType::Number, 0 });
-    registerInputPort({ "in_y", "Y", DataType::Number, 0 });
-    registerInputPort({ "in_size_x", "Size X", DataType::Number, 0 });
-    registerInputPort({ "in_size_y", "Size Y", DataType::Number, 0 });
+    registerInputPort({ IN_X, "X", DataType::Number, 0 });
+    registerInputPort({ IN_Y, "Y", DataType::Number, 0 });
+    registerInputPort({ IN_SIZE_X, "Size X", DataType::Number, 0 });
+    registerInputPort({ IN_SIZE_Y, "Size Y", DataType::Number, 0 });
 
-    registerInputPort({ "in_is_filling", "Fill", DataType::Number, false });
+    registerInputPort({ IN_IS_FILLING, "Fill", DataType::Number, false });
 
     // Output
-    registerOutputPort({ "out_color", "Color", DataType::Color });
-    registerOutputPort({ "out_grayscale", "Grayscale", DataType::Grayscale });
+    registerOutputPort({ OUT_COLOR, "Color", DataType::Color });
+    registerOutputPort({ OUT_GRAYSCALE, "Grayscale", DataType::Grayscale });
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::RectanglePatternNode::calculate(std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::RectanglePatternNode::calculate(const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outColor = std::make_shared<PixelBuffer>(bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    auto outColor = std::make_shared<ColorBuffer>(bufferSize);
     auto outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize);
 
     std::shared_ptr<VectorFieldBuffer> vectorField = nullptr;
-    if (inputs.count("in_vector")) {
-        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, "in_vector", bufferSize);
+    if (inputs.contains(IN_VECTOR)) {
+        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, IN_VECTOR, bufferSize);
     }
 
-    const auto colorBuffer = getRequiredInput<std::shared_ptr<PixelBuffer>>(inputs, "in_color", bufferSize);
-    const auto rectX = getRequiredInput<float>(inputs, "in_x", bufferSize);
-    const auto rectY = getRequiredInput<float>(inputs, "in_y", bufferSize);
-    const auto sizeX = getRequiredInput<float>(inputs, "in_size_x", bufferSize);
-    const auto sizeY = getRequiredInput<float>(inputs, "in_size_y", bufferSize);
-    const bool isFilling = static_cast<bool>(getRequiredInput<float>(inputs, "in_is_filling", bufferSize));
+    const auto colorInput = getRequiredInput<ColorInput>(inputs, IN_COLOR, bufferSize);
+    const auto rectX = getRequiredInput<float>(inputs, IN_X, bufferSize);
+    const auto rectY = getRequiredInput<float>(inputs, IN_Y, bufferSize);
+    const auto sizeX = getRequiredInput<float>(inputs, IN_SIZE_X, bufferSize);
+    const auto sizeY = getRequiredInput<float>(inputs, IN_SIZE_Y, bufferSize);
+    const bool isFilling = static_cast<bool>(getRequiredInput<float>(inputs, IN_IS_FILLING, bufferSize));
 
     const float left   = rectX;
     const float right  = rectX + sizeX;
     const float top    = rectY;
     const float bottom = rectY + sizeY;
 
-    for (unsigned y = 0; y < bufferSize.y; ++y) {
-        for (unsigned x = 0; x < bufferSize.x; ++x) {
-            auto sampleX = static_cast<float>(x);
-            auto sampleY = static_cast<float>(y);
-
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+            VectorFieldBuffer::ConstSpan vectorRow;
             if (vectorField) {
-                const sf::Vector2f distortion = vectorField->getVector({x, y});
-                sampleX += distortion.x;
-                sampleY += distortion.y;
+                vectorRow = vectorField->getRow(y);
             }
-
-            const bool inside = sampleX >= left && sampleX <= right && sampleY >= top && sampleY <= bottom;
-            if (!inside)
-                continue;
-
-            bool shouldDraw = isFilling;
-            if (!isFilling) {
-                const bool onLeft   = std::abs(sampleX - left) < 1;
-                const bool onRight  = std::abs(sampleX - right) < 1;
-                const bool onTop    = std::abs(sampleY - top) < 1;
-                const bool onBottom = std::abs(sampleY - bottom) < 1;
-                shouldDraw = onLeft || onRight || onTop || onBottom;
-            }
-
-            if (shouldDraw) {
-                const sf::Color finalColor = colorBuffer->getPixel({x, y});
-                outColor->setPixel({x, y}, finalColor);
-
-                const float luminance = 0.299f * static_cast<float>(finalColor.r) +
-                                        0.587f * static_cast<float>(finalColor.g) +
-                                        0.114f * static_cast<float>(finalColor.b);
-                outGrayscale->setValue({x, y}, static_cast<uint8_t>(luminance));
+            const auto inputRow = colorInput.getRow(y);
+            const auto colorRow = outColor->getRow(y);
+            const auto grayscaleRow = outGrayscale->getRow(y);
+
+            for (unsigned x = 0; x < bufferSize.x; ++x) {
+                auto sampleX = static_cast<float>(x);
+                auto sampleY = static_cast<float>(y);
+
+                if (vectorField) {
+                    const sf::Vector2f distortion = vectorRow[x];
+                    sampleX += distortion.x;
+                    sampleY += distortion.y;
+                }
+
+                const bool inside = sampleX >= left && sampleX <= right && sampleY >= top && sampleY <= bottom;
+                if (!inside)
+                    continue;
+
+                bool shouldDraw = isFilling;
+                if (!isFilling) {
+                    const bool onLeft   = std::abs(sampleX - left) < 1;
+                    const bool onRight  = std::abs(sampleX - right) < 1;
+                    const bool onTop    = std::abs(sampleY - top) < 1;
+                    const bool onBottom = std::abs(sampleY - bottom) < 1;
+                    shouldDraw = onLeft || onRight || onTop || onBottom;
+                }
+
+                if (shouldDraw) {
+                    const FloatColor finalColor = inputRow[x];
+                    colorRow[x] = finalColor;
+                    grayscaleRow[x] = Converters::toLuminance(finalColor);
+                }
             }
         }
-    }
+    });
 
-    return {{"out_color", std::move(outColor)},
-            {"out_grayscale", std::move(outGrayscale)}};
+    return {{OUT_COLOR, std::move(outColor)},
+            {OUT_GRAYSCALE, std::move(outGrayscale)}};
 }
\ No newline at end of file
@@ -2,20 +2,29 @@
 
 #include "PGS/node_graph/helpers.h"
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_COLOR{"in_color"};
+    const PGS::NodeGraph::PortID OUT_COLOR{"out_color"};
+}
+
 PGS::NodeGraph::RGBNode::RGBNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({ "in_color", "", DataType::Color, sf::Color::White });
+    registerInputPort({ IN_COLOR, "", DataType::Color, sf::Color::White });
 
     // Output
-    registerOutputPort({ "out_color", "Color", DataType::Color });
+    registerOutputPort({ OUT_COLOR, "Color", DataType::Color });
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::RGBNode::calculate(
-    std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::RGBNode::calculate(
+    const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto color = getRequiredInput<std::shared_ptr<PixelBuffer>>(inputs, "in_color", bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    const auto color = getRequiredInput<ColorInput>(inputs, IN_COLOR, bufferSize);
 
-    return {{"out_color", color}};
+    return {{OUT_COLOR, color.toNodeData()}};
 }
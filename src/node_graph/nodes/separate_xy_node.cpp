@@ -4,47 +4,72 @@
 #include "PGS/core/buffers/grayscale_buffer.h"
 #include <algorithm>
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_VECTOR{"in_vector"};
+    const PGS::NodeGraph::PortID OUT_X{"out_x"};
+    const PGS::NodeGraph::PortID OUT_Y{"out_y"};
+}
+
 PGS::NodeGraph::SeparateXYNode::SeparateXYNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({"in_vector", "Vector", DataType::VectorField});
+    registerInputPort({IN_VECTOR, "Vector", DataType::VectorField});
 
     // Output
-    registerOutputPort({"out_x", "X", DataType::Grayscale});
-    registerOutputPort({"out_y", "Y", DataType::Grayscale});
+    registerOutputPort({OUT_X, "X", DataType::Grayscale});
+    registerOutputPort({OUT_Y, "Y", DataType::Grayscale});
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> 
-PGS::NodeGraph::SeparateXYNode::calculate(std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs
+PGS::NodeGraph::SeparateXYNode::calculate(const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outX = std::make_shared<GrayscaleBuffer>(bufferSize);
-    auto outY = std::make_shared<GrayscaleBuffer>(bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    // Each output is one plane of the input, an unused one is not copied at all
+    std::shared_ptr<GrayscaleBuffer> outX;
+    if (context.isOutputDemanded(OUT_X))
+        outX = std::make_shared<GrayscaleBuffer>(bufferSize, Uninitialized);
+
+    std::shared_ptr<GrayscaleBuffer> outY;
+    if (context.isOutputDemanded(OUT_Y))
+        outY = std::make_shared<GrayscaleBuffer>(bufferSize, Uninitialized);
 
     std::shared_ptr<VectorFieldBuffer> inVector = nullptr;
-    if (inputs.count("in_vector")) {
-        inVector = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, "in_vector", bufferSize);
+    if (inputs.contains(IN_VECTOR)) {
+        inVector = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, IN_VECTOR, bufferSize);
     }
 
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            const sf::Vector2u pos = {x, y};
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        // The planes already are the outputs. Components outside [0, 1] are kept,
+        // so a Combine XY downstream gets the same vector back
+        const auto copyPlane = [&](GrayscaleBuffer& out, const std::span<const float> plane, const unsigned int y) {
+            if (plane.empty())
+                std::ranges::fill(out.getRow(y), 0.0f);
+            else
+                std::ranges::copy(plane, out.getRow(y).begin());
+        };
 
-            sf::Vector2f vec = {0.0f, 0.0f};
-            if (inVector) {
-                vec = inVector->getVector(pos);
-            }
+        for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+            VectorFieldBuffer::ConstSpan vectorRow;
+            if (inVector)
+                vectorRow = inVector->getRow(y);
 
-            const uint8_t valueX = static_cast<uint8_t>(std::clamp(vec.x, 0.0f, 1.0f) * 255.0f);
-            const uint8_t valueY = static_cast<uint8_t>(std::clamp(vec.y, 0.0f, 1.0f) * 255.0f);
-            
-            outX->setValue(pos, valueX);
-            outY->setValue(pos, valueY);
+            if (outX)
+                copyPlane(*outX, vectorRow.x, y);
+            if (outY)
+                copyPlane(*outY, vectorRow.y, y);
         }
-    }
+    });
+
+    NodeOutputs results;
+    if (outX)
+        results.emplace_back(OUT_X, std::move(outX));
+    if (outY)
+        results.emplace_back(OUT_Y, std::move(outY));
 
-    return {
-        {"out_x", std::move(outX)},
-        {"out_y", std::move(outY)}
-    };
+    return results;
 }
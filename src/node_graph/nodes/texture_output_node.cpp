@@ -2,14 +2,20 @@
 
 #include <stdexcept>
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_COLOR{"in_color"};
+}
+
 PGS::NodeGraph::TextureOutputNode::TextureOutputNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({ "in_color", "Color", DataType::Color });
+    registerInputPort({ IN_COLOR, "Color", DataType::Color });
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::TextureOutputNode::calculate(std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::TextureOutputNode::calculate(const NodeInputs& inputs, const EvaluationContext& context) const
 {
     throw std::runtime_error("Texture Output node can't calculate");
 }
@@ -2,20 +2,29 @@
 
 #include "PGS/node_graph/helpers.h"
 
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_VALUE{"in_value"};
+    const PGS::NodeGraph::PortID OUT_VALUE{"out_value"};
+}
+
 PGS::NodeGraph::ValueNode::ValueNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({ "in_value", "", DataType::Number, 0.0f });
+    registerInputPort({ IN_VALUE, "", DataType::Number, 0.0f });
 
     // Output
-    registerOutputPort({ "out_value", "Value", DataType::Number });
+    registerOutputPort({ OUT_VALUE, "Value", DataType::Number });
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::ValueNode::calculate(
-    std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::ValueNode::calculate(
+    const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto value = getRequiredInput<float>(inputs, "in_value", bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    auto value = getRequiredInput<float>(inputs, IN_VALUE, bufferSize);
 
-    return {{"out_value", value}};
+    return {{OUT_VALUE, value}};
 }
@@ -2,8 +2,28 @@
 
 #include "PGS/node_graph/helpers.h"
 #include "PGS/node_graph/converters.h"
+#include "PGS/node_graph/utils/value_range.h"
 
+#include <cmath>
+#include <limits>
 #include <random>
+#include <utility>
+
+namespace
+{
+    // Port ids, interned once instead of on every lookup
+    const PGS::NodeGraph::PortID IN_FEATURE{"in_feature"};
+    const PGS::NodeGraph::PortID IN_METRIC{"in_metric"};
+    const PGS::NodeGraph::PortID IN_NORMALIZE{"in_normalize"};
+    const PGS::NodeGraph::PortID IN_VECTOR{"in_vector"};
+    const PGS::NodeGraph::PortID IN_SCALE{"in_scale"};
+    const PGS::NodeGraph::PortID IN_DETAIL{"in_detail"};
+    const PGS::NodeGraph::PortID IN_ROUGHNESS{"in_roughness"};
+    const PGS::NodeGraph::PortID IN_LACUNARITY{"in_lacunarity"};
+    const PGS::NodeGraph::PortID IN_RANDOMNESS{"in_randomness"};
+    const PGS::NodeGraph::PortID OUT_GRAYSCALE{"out_grayscale"};
+    const PGS::NodeGraph::PortID OUT_COLOR{"out_color"};
+}
 
 
 // -- Private --
@@ -33,8 +53,8 @@ std::vector<sf::Vector2f> PGS::NodeGraph::VoronoiTextureNode::generateFeaturePoi
     std::mt19937 rng(seed);
     std::uniform_real_distribution jitter(-0.5f, 0.5f);
 
-    const int gridX = static_cast<int>(scale);
-    const int gridY = static_cast<int>(scale);
+    const int gridX = getGridSize(scale);
+    const int gridY = getGridSize(scale);
 
     for (int gy = 0; gy < gridY; ++gy) {
         for (int gx = 0; gx < gridX; ++gx) {
@@ -48,128 +68,224 @@ std::vector<sf::Vector2f> PGS::NodeGraph::VoronoiTextureNode::generateFeaturePoi
 }
 
 
+int PGS::NodeGraph::VoronoiTextureNode::getGridSize(const float scale)
+{
+    return std::max(1, static_cast<int>(scale));
+}
+
+
 // -- Public --
 PGS::NodeGraph::VoronoiTextureNode::VoronoiTextureNode(const NodeID id, std::string name)
     : Node(id, std::move(name))
 {
     // Input
-    registerInputPort({"in_feature", "", DataType::Number, ValueList{0, {"F1", "F2", "Smooth F1"}}});
-    registerInputPort({"in_metric", "", DataType::Number, ValueList{0, {"Euclidean", "Manhattan", "Chebyshev"}}});
+    registerInputPort({IN_FEATURE, "", DataType::Number, ValueList{0, {"F1", "F2", "Smooth F1"}}});
+    registerInputPort({IN_METRIC, "", DataType::Number, ValueList{0, {"Euclidean", "Manhattan", "Chebyshev"}}});
 
-    registerInputPort({"in_normalize", "Normalize", DataType::Number, true});
-    registerInputPort({"in_vector", "Vector", DataType::VectorField});
+    registerInputPort({IN_NORMALIZE, "Normalize", DataType::Number, true});
+    registerInputPort({IN_VECTOR, "Vector", DataType::VectorField});
 
-    registerInputPort({"in_scale", "Scale", DataType::Number, 5.0f});
-    registerInputPort({"in_detail", "Detail", DataType::Number, 0.0f});
-    registerInputPort({"in_roughness", "Roughness", DataType::Number, 0.5f,
+    registerInputPort({IN_SCALE, "Scale", DataType::Number, 5.0f});
+    registerInputPort({IN_DETAIL, "Detail", DataType::Number, 0.0f});
+    registerInputPort({IN_ROUGHNESS, "Roughness", DataType::Number, 0.5f,
         Metadata{.description = "Roughness of the effect", .minValue = 0.0f, .maxValue = 1.0f}});
 
-    registerInputPort({"in_lacunarity", "Lacunarity", DataType::Number, 2.0f});
-    registerInputPort({"in_randomness", "Randomness", DataType::Number, 1.0f,
+    registerInputPort({IN_LACUNARITY, "Lacunarity", DataType::Number, 2.0f});
+    registerInputPort({IN_RANDOMNESS, "Randomness", DataType::Number, 1.0f,
         Metadata{.description = "Randomness of the effect", .minValue = 0.0f, .maxValue = 1.0f}});
 
     // Output
-    registerOutputPort({"out_grayscale", "Distance", DataType::Grayscale});
-    registerOutputPort({"out_color", "Color", DataType::Color});
+    registerOutputPort({OUT_GRAYSCALE, "Distance", DataType::Grayscale});
+    registerOutputPort({OUT_COLOR, "Color", DataType::Color});
 }
 
-std::unordered_map<PGS::NodeGraph::PortID, PGS::NodeGraph::NodeData> PGS::NodeGraph::VoronoiTextureNode::calculate(
-    std::unordered_map<PortID, NodeData>& inputs, const sf::Vector2u& bufferSize) const
+PGS::NodeGraph::NodeOutputs PGS::NodeGraph::VoronoiTextureNode::calculate(
+    const NodeInputs& inputs, const EvaluationContext& context) const
 {
-    auto outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize);
-    auto outColor = std::make_shared<PixelBuffer>(bufferSize);
+    const sf::Vector2u& bufferSize = context.bufferSize;
+
+    // The distances and the cell colors are independent, each is only computed for a used output
+    const bool grayscaleDemanded = context.isOutputDemanded(OUT_GRAYSCALE);
+    const bool colorDemanded = context.isOutputDemanded(OUT_COLOR);
 
-    const auto feature = static_cast<int>(getRequiredInput<float>(inputs, "in_feature", bufferSize));
-    const auto metric = static_cast<int>(getRequiredInput<float>(inputs, "in_metric", bufferSize));
-    const bool normalize = static_cast<bool>(getRequiredInput<float>(inputs, "in_normalize", bufferSize));
-    const auto scale = getRequiredInput<float>(inputs, "in_scale", bufferSize);
-    const auto randomness = getRequiredInput<float>(inputs, "in_randomness", bufferSize);
+    const auto feature = static_cast<int>(getRequiredInput<float>(inputs, IN_FEATURE, bufferSize));
+    const auto metric = static_cast<int>(getRequiredInput<float>(inputs, IN_METRIC, bufferSize));
+    const bool normalize = static_cast<bool>(getRequiredInput<float>(inputs, IN_NORMALIZE, bufferSize));
+    const auto scale = getRequiredInput<float>(inputs, IN_SCALE, bufferSize);
+    const auto randomness = getRequiredInput<float>(inputs, IN_RANDOMNESS, bufferSize);
 
     std::shared_ptr<VectorFieldBuffer> vectorField = nullptr;
-    if (inputs.count("in_vector")) {
-        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, "in_vector", bufferSize);
+    if (inputs.contains(IN_VECTOR)) {
+        vectorField = getRequiredInput<std::shared_ptr<VectorFieldBuffer>>(inputs, IN_VECTOR, bufferSize);
     }
 
     const auto points = generateFeaturePoints(scale, randomness);
 
-    std::vector<float> distancesBuffer(bufferSize.x * bufferSize.y);
-    std::vector<size_t> closestIDs(bufferSize.x * bufferSize.y);
+    // Point i belongs to cell (i % gridSize, i / gridSize), so colors can be computed once per cell
+    const int gridSize = getGridSize(scale);
+    const float cellSize = 1.0f / static_cast<float>(gridSize);
 
-    float minDist = std::numeric_limits<float>::max();
-    float maxDist = std::numeric_limits<float>::lowest();
+    std::vector<FloatColor> cellColors;
+    if (colorDemanded) {
+        cellColors.resize(points.size());
+        for (size_t i = 0; i < points.size(); ++i)
+            cellColors[i] = Converters::toFloatColor(idToColor(i));
+    }
+
+    // With randomness above 1 the jitter can move a point out of its own cell by up to this distance
+    const float jitterSlack = std::max(0.0f, (std::abs(randomness) - 1.0f) * 0.5f) * cellSize;
+    const bool needsSecondDistance = grayscaleDemanded && feature != F1;
+
+    // Both outputs are written in the same pass: the cell colors directly, the distances raw, to be
+    // normalized in place afterwards. Their range is reduced per band while the rows are still in the cache.
+    std::shared_ptr<GrayscaleBuffer> outGrayscale;
+    if (grayscaleDemanded)
+        outGrayscale = std::make_shared<GrayscaleBuffer>(bufferSize, Uninitialized);
+
+    std::shared_ptr<ColorBuffer> outColor;
+    if (colorDemanded)
+        outColor = std::make_shared<ColorBuffer>(bufferSize, Uninitialized);
 
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            sf::Vector2f coord = {
-                static_cast<float>(x) / static_cast<float>(bufferSize.x),
-                static_cast<float>(y) / static_cast<float>(bufferSize.y)
-            };
+    Utils::ConcurrentValueRange distanceRange;
 
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        Utils::ValueRange bandRange;
+
+        for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+            const auto uvRow = std::as_const(*context.uvField).getRow(y);
+            VectorFieldBuffer::ConstSpan vectorRow;
             if (vectorField) {
-                coord += vectorField->getVector({x, y});
+                vectorRow = vectorField->getRow(y);
             }
 
-            std::vector<std::pair<float, size_t>> distances;
-            distances.reserve(points.size());
+            const std::span<float> distanceRow = outGrayscale ? outGrayscale->getRow(y) : std::span<float>{};
+            const std::span<FloatColor> colorRow = outColor ? outColor->getRow(y) : std::span<FloatColor>{};
 
-            for (size_t i = 0; i < points.size(); ++i) {
-                float d = distance(coord, points[i], metric);
-                distances.emplace_back(d, i);
-            }
+            for (unsigned int x = 0; x < bufferSize.x; ++x) {
+                sf::Vector2f coord = uvRow[x];
 
-            std::sort(distances.begin(), distances.end(),
-                      [](const auto& a, const auto& b) { return a.first < b.first; });
-
-            float val = 0.f;
-            switch (feature) {
-                case F1:
-                    val = distances[0].first;
-                    break;
-                case F2:
-                    val = distances.size() > 1 ? distances[1].first : distances[0].first;
-                    break;
-                case SmoothF1: {
-                    float d0 = distances[0].first;
-                    float d1 = distances.size() > 1 ? distances[1].first : d0;
-                    val = 0.5f * (d0 + d1);
-                    break;
+                if (vectorField) {
+                    coord += vectorRow[x];
+                }
+
+                const int cellX = std::clamp(static_cast<int>(std::floor(coord.x * static_cast<float>(gridSize))), 0, gridSize - 1);
+                const int cellY = std::clamp(static_cast<int>(std::floor(coord.y * static_cast<float>(gridSize))), 0, gridSize - 1);
+
+                // Two smallest distances (F1, F2) and the point of F1
+                float d1 = std::numeric_limits<float>::max();
+                float d2 = std::numeric_limits<float>::max();
+                size_t closestID = 0;
+
+                const auto visitCell = [&](const int cx, const int cy) {
+                    if (cx < 0 || cy < 0 || cx >= gridSize || cy >= gridSize)
+                        return;
+
+                    const size_t i = static_cast<size_t>(cy) * gridSize + cx;
+                    const float d = distance(coord, points[i], metric);
+
+                    if (d < d1) {
+                        d2 = d1;
+                        d1 = d;
+                        closestID = i;
+                    } else if (d < d2) {
+                        d2 = d;
+                    }
+                };
+
+                // Search rings of cells around the pixel's cell: the 3x3 neighborhood first, then wider rings
+                // only while a point outside the searched window could still be closer than F1 (or F2)
+                for (int radius = 0; radius < gridSize; ++radius) {
+                    for (int cy = cellY - radius; cy <= cellY + radius; ++cy) {
+                        if (cy == cellY - radius || cy == cellY + radius) {
+                            for (int cx = cellX - radius; cx <= cellX + radius; ++cx)
+                                visitCell(cx, cy);
+                        } else {
+                            visitCell(cellX - radius, cy);
+                            visitCell(cellX + radius, cy);
+                        }
+                    }
+
+                    if (radius == 0)
+                        continue;
+
+                    // Every metric is at least the distance along one axis, so points beyond the window
+                    // are no closer than the nearest window edge that still has cells behind it
+                    constexpr float NO_CELLS = std::numeric_limits<float>::max();
+                    const float left   = cellX - radius > 0 ? coord.x - static_cast<float>(cellX - radius) * cellSize : NO_CELLS;
+                    const float right  = cellX + radius < gridSize - 1 ? static_cast<float>(cellX + radius + 1) * cellSize - coord.x : NO_CELLS;
+                    const float top    = cellY - radius > 0 ? coord.y - static_cast<float>(cellY - radius) * cellSize : NO_CELLS;
+                    const float bottom = cellY + radius < gridSize - 1 ? static_cast<float>(cellY + radius + 1) * cellSize - coord.y : NO_CELLS;
+
+                    const float edgeDistance = std::min({left, right, top, bottom});
+                    if (edgeDistance == NO_CELLS || edgeDistance - jitterSlack >= (needsSecondDistance ? d2 : d1))
+                        break;
                 }
-                default:
-                    val = distances[0].first;
-                    break;
-            }
 
-            distancesBuffer[y * bufferSize.x + x] = val;
-            closestIDs[y * bufferSize.x + x] = distances[0].second;
+                if (colorDemanded) {
+                    colorRow[x] = cellColors[closestID];
+                }
 
-            minDist = std::min(minDist, val);
-            maxDist = std::max(maxDist, val);
-        }
-    }
+                if (!grayscaleDemanded) {
+                    continue;
+                }
 
-    float range = maxDist - minDist;
-    if (range < 1e-6f) range = 1.0f;
+                const float f2 = points.size() > 1 ? d2 : d1;
+
+                float val = 0.f;
+                switch (feature) {
+                    case F1:
+                        val = d1;
+                        break;
+                    case F2:
+                        val = f2;
+                        break;
+                    case SmoothF1:
+                        val = 0.5f * (d1 + f2);
+                        break;
+                    default:
+                        val = d1;
+                        break;
+                }
 
-    for (unsigned int y = 0; y < bufferSize.y; ++y) {
-        for (unsigned int x = 0; x < bufferSize.x; ++x) {
-            const size_t index = y * bufferSize.x + x;
+                distanceRow[x] = val;
+            }
 
-            float val = distancesBuffer[index];
-            if (normalize) {
-                val = (val - minDist) / range;
+            if (grayscaleDemanded && normalize) {
+                bandRange.include(distanceRow);
             }
-            val = std::clamp(val, 0.f, 1.f);
+        }
 
-            const size_t id = closestIDs[index];
+        distanceRange.merge(bandRange);
+    });
 
-            outGrayscale->setValue({x, y}, static_cast<uint8_t>(val * 255));
-            outColor->setPixel({x, y}, idToColor(id));
-        }
+    NodeOutputs results;
+
+    if (grayscaleDemanded) {
+        const Utils::ValueRange distances = distanceRange.get();
+        const float minDist = distances.min;
+
+        float range = distances.max - distances.min;
+        if (range < 1e-6f) range = 1.0f;
+
+        context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+        {
+            for (unsigned int y = rowBegin; y < rowEnd; ++y) {
+                for (float& val : outGrayscale->getRow(y)) {
+                    if (normalize) {
+                        val = (val - minDist) / range;
+                    }
+                    val = std::clamp(val, 0.f, 1.f);
+                }
+            }
+        });
+
+        results.emplace_back(OUT_GRAYSCALE, std::move(outGrayscale));
     }
 
-    return {
-        {"out_grayscale", std::move(outGrayscale)},
-        {"out_color", std::move(outColor)}
-    };
+    if (colorDemanded) {
+        results.emplace_back(OUT_COLOR, std::move(outColor));
+    }
 
+    return results;
 }
@@ -0,0 +1,16 @@
+#include "PGS/node_graph/pointwise_node.h"
+
+#include "PGS/core/buffers/color_buffer.h"
+
+std::shared_ptr<PGS::ColorBuffer> PGS::NodeGraph::PointwiseNode::runKernel(const PointwiseKernel& kernel, const EvaluationContext& context)
+{
+    auto buffer = std::make_shared<ColorBuffer>(context.bufferSize, Uninitialized);
+
+    context.forEachRowBand([&](const unsigned int rowBegin, const unsigned int rowEnd)
+    {
+        for (unsigned int y = rowBegin; y < rowEnd; ++y)
+            kernel(y, 0, buffer->getRow(y));
+    });
+
+    return buffer;
+}
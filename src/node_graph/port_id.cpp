@@ -0,0 +1,70 @@
+#include "PGS/node_graph/port_id.h"
+
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+namespace
+{
+    struct PortRegistry
+    {
+        std::mutex mutex;
+        std::deque<std::string> names; // Deque: growing it never moves the stored names
+        std::unordered_map<std::string_view, const std::string*> lookup;
+    };
+
+    // Function-local so it is ready for port constants defined at namespace scope in other files
+    PortRegistry& getRegistry()
+    {
+        static PortRegistry registry;
+        return registry;
+    }
+}
+
+const std::string* PGS::NodeGraph::PortID::intern(const std::string_view name)
+{
+    auto& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+
+    if (const auto it = registry.lookup.find(name); it != registry.lookup.end())
+        return it->second;
+
+    const std::string& stored = registry.names.emplace_back(name);
+    registry.lookup.emplace(stored, &stored);
+
+    return &stored;
+}
+
+PGS::NodeGraph::PortID::PortID()
+{
+    static const std::string* const emptyName = intern({});
+    m_name = emptyName;
+}
+
+PGS::NodeGraph::PortID::PortID(const char* name)
+    : m_name(intern(name))
+{}
+
+PGS::NodeGraph::PortID::PortID(const std::string& name)
+    : m_name(intern(name))
+{}
+
+PGS::NodeGraph::PortID::PortID(const std::string_view name)
+    : m_name(intern(name))
+{}
+
+std::ostream& PGS::NodeGraph::operator<<(std::ostream& stream, const PortID& portId)
+{
+    return stream << portId.str();
+}
+
+std::istream& PGS::NodeGraph::operator>>(std::istream& stream, PortID& portId)
+{
+    std::string name;
+    if (stream >> name)
+        portId = PortID{name};
+
+    return stream;
+}
@@ -0,0 +1,221 @@
+#include "PGS/node_graph/result_cache.h"
+
+#include "PGS/core/buffers/color_buffer.h"
+#include "PGS/core/buffers/grayscale_buffer.h"
+#include "PGS/core/buffers/vector_field_buffer.h"
+
+#include <algorithm>
+#include <utility>
+
+std::optional<PGS::NodeGraph::ResultCache::Entry> PGS::NodeGraph::ResultCache::find(const Signature& signature)
+{
+    std::lock_guard lock(m_mutex);
+
+    const auto entryIt = m_entries.find(signature.key);
+    if (entryIt == m_entries.end() || entryIt->second.inputs != signature.inputs)
+    {
+        ++m_stats.misses;
+        return std::nullopt;
+    }
+
+    ++m_stats.hits;
+    m_useOrder.splice(m_useOrder.begin(), m_useOrder, entryIt->second.usePosition);
+
+    return entryIt->second.entry;
+}
+
+void PGS::NodeGraph::ResultCache::insert(const Signature& signature, Entry entry)
+{
+    const size_t bytes = computeBytes(entry);
+
+    std::lock_guard lock(m_mutex);
+
+    if (const auto entryIt = m_entries.find(signature.key); entryIt != m_entries.end())
+    {
+        uncountEntry(entryIt->second, nullptr);
+        m_useOrder.erase(entryIt->second.usePosition);
+        m_entries.erase(entryIt);
+    }
+
+    if (bytes > m_maxBytes)
+        return;
+
+    evict(m_maxBytes - bytes);
+
+    m_useOrder.push_front(signature.key);
+    auto& stored = m_entries.emplace(signature.key, StoredEntry{std::move(entry), signature.inputs, {}, 0, m_useOrder.begin()}).first->second;
+
+    for (const auto& output : stored.entry.outputs)
+    {
+        if (output.has_value())
+            countOutput(stored, *output);
+    }
+
+    countConversions(stored);
+}
+
+bool PGS::NodeGraph::ResultCache::trim(const std::span<const NodeData> liveData)
+{
+    std::lock_guard lock(m_mutex);
+
+    // Consumers convert the outputs while they read them, long after the entry was inserted
+    for (auto& [key, stored] : m_entries)
+        countConversions(stored);
+
+    LiveBuffers live;
+    m_liveBytes = 0;
+
+    for (const NodeData& data : liveData)
+    {
+        const auto [buffer, bytes] = describe(data);
+        if (buffer == nullptr || !live.insert(buffer).second)
+            continue;
+
+        if (!m_buffers.contains(buffer))
+            m_liveBytes += bytes;
+    }
+
+    evict(m_maxBytes, &live);
+
+    return m_entryBytes + m_liveBytes <= m_maxBytes;
+}
+
+void PGS::NodeGraph::ResultCache::setMaxBytes(const size_t maxBytes)
+{
+    std::lock_guard lock(m_mutex);
+
+    m_maxBytes = maxBytes;
+    evict(m_maxBytes);
+}
+
+size_t PGS::NodeGraph::ResultCache::getMaxBytes() const
+{
+    std::lock_guard lock(m_mutex);
+
+    return m_maxBytes;
+}
+
+PGS::NodeGraph::ResultCache::Stats PGS::NodeGraph::ResultCache::getStats() const
+{
+    std::lock_guard lock(m_mutex);
+
+    Stats stats = m_stats;
+    stats.entryCount = m_entries.size();
+    stats.residentBytes = m_entryBytes + m_liveBytes;
+    stats.liveBytes = m_liveBytes;
+    return stats;
+}
+
+std::pair<const void*, size_t> PGS::NodeGraph::ResultCache::describe(const NodeData& data)
+{
+    return std::visit([](const auto& value) -> std::pair<const void*, size_t>
+    {
+        using T = std::decay_t<decltype(value)>;
+
+        if constexpr (std::is_same_v<T, std::shared_ptr<GrayscaleBuffer>>)
+            return {value.get(), size_t{value->getSize().x} * value->getSize().y * sizeof(float)};
+        else if constexpr (std::is_same_v<T, std::shared_ptr<ColorBuffer>>)
+            return {value.get(), size_t{value->getSize().x} * value->getSize().y * sizeof(FloatColor)};
+        else if constexpr (std::is_same_v<T, std::shared_ptr<VectorFieldBuffer>>)
+            return {value.get(), size_t{value->getSize().x} * value->getSize().y * 2 * sizeof(float)};
+        else
+            return {nullptr, sizeof(T)};
+    }, data);
+}
+
+size_t PGS::NodeGraph::ResultCache::computeBytes(const Entry& entry)
+{
+    size_t bytes = 0;
+    std::vector<const void*> buffers;
+
+    for (const auto& output : entry.outputs)
+    {
+        if (!output.has_value())
+            continue;
+
+        const auto [buffer, outputBytes] = describe(*output);
+        if (buffer != nullptr && std::find(buffers.begin(), buffers.end(), buffer) != buffers.end())
+            continue;
+
+        buffers.push_back(buffer);
+        bytes += outputBytes;
+    }
+
+    return bytes;
+}
+
+void PGS::NodeGraph::ResultCache::countOutput(StoredEntry& stored, const NodeData& data)
+{
+    const auto [buffer, bytes] = describe(data);
+
+    if (buffer == nullptr)
+    {
+        stored.valueBytes += bytes;
+        m_entryBytes += bytes;
+        return;
+    }
+
+    if (std::find(stored.buffers.begin(), stored.buffers.end(), buffer) != stored.buffers.end())
+        return;
+
+    stored.buffers.push_back(buffer);
+
+    const auto [bufferIt, inserted] = m_buffers.try_emplace(buffer, BufferUse{bytes, 0});
+    if (inserted)
+        m_entryBytes += bytes;
+
+    ++bufferIt->second.entryCount;
+}
+
+void PGS::NodeGraph::ResultCache::countConversions(StoredEntry& stored)
+{
+    for (const auto& conversions : stored.entry.conversions)
+    {
+        if (!conversions)
+            continue;
+
+        std::lock_guard lock(conversions->mutex);
+
+        // Converted values (a grayscale buffer read as a number) are a few bytes and may be counted again on every
+        // call, so only buffers are counted
+        for (const auto& converted : conversions->byType)
+        {
+            if (converted.has_value() && describe(*converted).first != nullptr)
+                countOutput(stored, *converted);
+        }
+    }
+}
+
+void PGS::NodeGraph::ResultCache::uncountEntry(const StoredEntry& stored, const LiveBuffers* live)
+{
+    m_entryBytes -= stored.valueBytes;
+
+    for (const void* buffer : stored.buffers)
+    {
+        const auto bufferIt = m_buffers.find(buffer);
+        if (--bufferIt->second.entryCount > 0)
+            continue;
+
+        m_entryBytes -= bufferIt->second.bytes;
+
+        // Still kept alive by the owner
+        if (live != nullptr && live->contains(buffer))
+            m_liveBytes += bufferIt->second.bytes;
+
+        m_buffers.erase(bufferIt);
+    }
+}
+
+void PGS::NodeGraph::ResultCache::evict(const size_t maxBytes, const LiveBuffers* live)
+{
+    while (m_entryBytes + m_liveBytes > maxBytes && !m_useOrder.empty())
+    {
+        const auto entryIt = m_entries.find(m_useOrder.back());
+
+        uncountEntry(entryIt->second, live);
+        ++m_stats.evictions;
+
+        m_entries.erase(entryIt);
+        m_useOrder.pop_back();
+    }
+}
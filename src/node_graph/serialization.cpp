@@ -0,0 +1,274 @@
+#include "PGS/node_graph/serialization.h"
+
+#include "PGS/node_graph/evaluator.h"
+#include "PGS/node_graph/node.h"
+#include "PGS/node_graph/nodes/texture_output_node.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    using namespace PGS::NodeGraph;
+
+    [[noreturn]] void throwParseError(const size_t lineNumber, const std::string& message)
+    {
+        throw std::runtime_error("Graph parse error at line " + std::to_string(lineNumber) + ": " + message);
+    }
+
+    std::string readRest(std::istringstream& stream)
+    {
+        std::string rest;
+        std::getline(stream >> std::ws, rest);
+
+        while (!rest.empty() && (rest.back() == '\r' || rest.back() == ' ' || rest.back() == '\t'))
+            rest.pop_back();
+
+        return rest;
+    }
+
+    NodeID createNodeByTypeName(Evaluator& evaluator, const std::string& typeName)
+    {
+        for (const auto& [typeIndex, factoryInfo] : evaluator.getNodeFactories())
+        {
+            if (factoryInfo.name == typeName)
+                return evaluator.addNode(typeIndex);
+        }
+
+        return INVALID_NODE_ID;
+    }
+
+    NodeID findUnusedOutputNode(const Evaluator& evaluator, const std::unordered_set<NodeID>& usedNodes)
+    {
+        NodeID result = INVALID_NODE_ID;
+
+        for (const auto& [nodeId, node] : evaluator.getNodes())
+        {
+            if (dynamic_cast<const TextureOutputNode*>(node.get()) == nullptr || usedNodes.count(nodeId))
+                continue;
+
+            if (result == INVALID_NODE_ID || nodeId < result)
+                result = nodeId;
+        }
+
+        return result;
+    }
+
+    void applyValue(Evaluator& evaluator, const NodeID nodeId, const InputPort& port,
+                    std::istringstream& stream, const size_t lineNumber)
+    {
+        if (!port.value.has_value())
+            throwParseError(lineNumber, "port '" + port.id.str() + "' has no editable value");
+
+        std::visit([&](auto&& current)
+        {
+            using T = std::decay_t<decltype(current)>;
+
+            if constexpr (std::is_same_v<T, float>)
+            {
+                float value = 0.0f;
+                if (!(stream >> value))
+                    throwParseError(lineNumber, "expected a number for port '" + port.id.str() + "'");
+                evaluator.setNodeInputPortValue(nodeId, port.id, value);
+            }
+            else if constexpr (std::is_same_v<T, int>)
+            {
+                int value = 0;
+                if (!(stream >> value))
+                    throwParseError(lineNumber, "expected an integer for port '" + port.id.str() + "'");
+                evaluator.setNodeInputPortValue(nodeId, port.id, value);
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                std::string token;
+                stream >> token;
+                if (token == "1" || token == "true")
+                    evaluator.setNodeInputPortValue(nodeId, port.id, true);
+                else if (token == "0" || token == "false")
+                    evaluator.setNodeInputPortValue(nodeId, port.id, false);
+                else
+                    throwParseError(lineNumber, "expected a boolean for port '" + port.id.str() + "'");
+            }
+            else if constexpr (std::is_same_v<T, sf::Color>)
+            {
+                int r = 0, g = 0, b = 0, a = 255;
+                if (!(stream >> r >> g >> b))
+                    throwParseError(lineNumber, "expected 'r g b [a]' for port '" + port.id.str() + "'");
+                stream >> a;
+
+                const auto channel = [](const int value) { return static_cast<std::uint8_t>(std::clamp(value, 0, 255)); };
+                evaluator.setNodeInputPortValue(nodeId, port.id, sf::Color{channel(r), channel(g), channel(b), channel(a)});
+            }
+            else if constexpr (std::is_same_v<T, ValueList>)
+            {
+                int index = 0;
+                if (!(stream >> index) || index < 0 || index >= static_cast<int>(current.second.size()))
+                    throwParseError(lineNumber, "expected an option index for port '" + port.id.str() + "'");
+                evaluator.setNodeInputPortValue<ValueList>(nodeId, port.id, {index, current.second});
+            }
+        }, *port.value);
+    }
+}
+
+void PGS::NodeGraph::Serialization::loadGraph(Evaluator& evaluator, std::istream& input)
+{
+    std::unordered_map<NodeID, NodeID> fileToEvaluatorIds;
+    std::unordered_set<NodeID> usedNodes;
+
+    const auto resolveNode = [&](const NodeID fileId, const size_t lineNumber)
+    {
+        const auto it = fileToEvaluatorIds.find(fileId);
+        if (it == fileToEvaluatorIds.end())
+            throwParseError(lineNumber, "unknown node id " + std::to_string(fileId));
+
+        return it->second;
+    };
+
+    std::string line;
+    size_t lineNumber = 0;
+
+    while (std::getline(input, line))
+    {
+        ++lineNumber;
+
+        std::istringstream stream{line};
+        std::string keyword;
+        if (!(stream >> keyword) || keyword.front() == '#')
+            continue;
+
+        if (keyword == "node")
+        {
+            NodeID fileId = INVALID_NODE_ID;
+            if (!(stream >> fileId))
+                throwParseError(lineNumber, "expected a node id");
+
+            if (fileToEvaluatorIds.count(fileId))
+                throwParseError(lineNumber, "duplicate node id " + std::to_string(fileId));
+
+            const std::string typeName = readRest(stream);
+
+            NodeID nodeId = INVALID_NODE_ID;
+            if (typeName == evaluator.getNodeFactories().at(typeid(TextureOutputNode)).name)
+                nodeId = findUnusedOutputNode(evaluator, usedNodes);
+
+            if (nodeId == INVALID_NODE_ID)
+                nodeId = createNodeByTypeName(evaluator, typeName);
+
+            if (nodeId == INVALID_NODE_ID)
+                throwParseError(lineNumber, "unknown node type '" + typeName + "'");
+
+            fileToEvaluatorIds[fileId] = nodeId;
+            usedNodes.insert(nodeId);
+        }
+        else if (keyword == "set")
+        {
+            NodeID fileId = INVALID_NODE_ID;
+            PortID portId;
+            if (!(stream >> fileId >> portId))
+                throwParseError(lineNumber, "expected 'set <node id> <port id> <value>'");
+
+            const NodeID nodeId = resolveNode(fileId, lineNumber);
+            const auto& node = *evaluator.getNodes().at(nodeId);
+
+            const auto& ports = node.getInputPorts();
+            const auto portIt = std::find_if(ports.begin(), ports.end(),
+                [&](const InputPort& port) { return port.id == portId; });
+
+            if (portIt == ports.end())
+                throwParseError(lineNumber, "node '" + node.getName() + "' has no input port '" + portId.str() + "'");
+
+            applyValue(evaluator, nodeId, *portIt, stream, lineNumber);
+        }
+        else if (keyword == "link")
+        {
+            NodeID sourceFileId = INVALID_NODE_ID;
+            NodeID targetFileId = INVALID_NODE_ID;
+            PortID sourcePortId, targetPortId;
+            if (!(stream >> sourceFileId >> sourcePortId >> targetFileId >> targetPortId))
+                throwParseError(lineNumber, "expected 'link <source id> <source port> <target id> <target port>'");
+
+            const Connection connection{
+                resolveNode(sourceFileId, lineNumber), sourcePortId,
+                resolveNode(targetFileId, lineNumber), targetPortId
+            };
+
+            evaluator.addConnection(connection);
+
+            if (!evaluator.getConnections().count({connection.targetNodeId, connection.targetPortId}))
+                throwParseError(lineNumber, "connection was rejected (unknown port, type mismatch or cycle)");
+        }
+        else
+        {
+            throwParseError(lineNumber, "unknown statement '" + keyword + "'");
+        }
+    }
+}
+
+void PGS::NodeGraph::Serialization::saveGraph(const Evaluator& evaluator, std::ostream& output)
+{
+    std::vector<NodeID> nodeIds;
+    for (const auto& [nodeId, node] : evaluator.getNodes())
+        nodeIds.push_back(nodeId);
+    std::sort(nodeIds.begin(), nodeIds.end());
+
+    const auto precision = output.precision(std::numeric_limits<float>::max_digits10);
+
+    output << "# PixelGen Studio graph\n";
+
+    for (const NodeID nodeId : nodeIds)
+    {
+        const auto& node = *evaluator.getNodes().at(nodeId);
+        output << "node " << nodeId << ' ' << evaluator.getNodeFactories().at(typeid(node)).name << '\n';
+    }
+
+    for (const NodeID nodeId : nodeIds)
+    {
+        for (const auto& port : evaluator.getNodes().at(nodeId)->getInputPorts())
+        {
+            if (!port.value.has_value())
+                continue;
+
+            output << "set " << nodeId << ' ' << port.id << ' ';
+
+            std::visit([&](auto&& value)
+            {
+                using T = std::decay_t<decltype(value)>;
+
+                if constexpr (std::is_same_v<T, sf::Color>)
+                    output << +value.r << ' ' << +value.g << ' ' << +value.b << ' ' << +value.a;
+                else if constexpr (std::is_same_v<T, ValueList>)
+                    output << value.first;
+                else if constexpr (std::is_same_v<T, bool>)
+                    output << (value ? 1 : 0);
+                else
+                    output << value;
+            }, *port.value);
+
+            output << '\n';
+        }
+    }
+
+    std::vector<Connection> connections;
+    for (const auto& [locator, connection] : evaluator.getConnections())
+        connections.push_back(connection);
+
+    std::sort(connections.begin(), connections.end(), [](const Connection& a, const Connection& b)
+    {
+        return std::tie(a.targetNodeId, a.targetPortId) < std::tie(b.targetNodeId, b.targetPortId);
+    });
+
+    for (const auto& connection : connections)
+    {
+        output << "link " << connection.sourceNodeId << ' ' << connection.sourcePortId << ' '
+               << connection.targetNodeId << ' ' << connection.targetPortId << '\n';
+    }
+
+    output.precision(precision);
+}
@@ -1,18 +1,90 @@
 #include "PGS/node_graph/utils/perlin_noise_2d.h"
+#include "PGS/node_graph/utils/perlin_noise_2d_kernels.h"
 
 #include <random>
 #include <numeric>
 #include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <unordered_map>
 
-PGS::NodeGraph::Utils::PerlinNoise2D::PerlinNoise2D(const unsigned int seed) {
-    permutation.resize(256);
-    std::iota(permutation.begin(), permutation.end(), 0);
+#if defined(PGS_PERLIN_X86_KERNELS) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    using BatchKernel = void (*)(const int* table, const float* xs, const float* ys, float* values, std::size_t count);
+
+#if defined(PGS_PERLIN_X86_KERNELS)
+#if defined(_MSC_VER)
+    bool cpuHasSse41() {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 19)) != 0;
+    }
+
+    bool cpuHasAvx2() {
+        int info[4];
+        __cpuid(info, 1);
+
+        // The OS must save the YMM registers too (OSXSAVE + XCR0 bits 1 and 2)
+        const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        if (!osSavesYmm)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+#else
+    bool cpuHasSse41() { return __builtin_cpu_supports("sse4.1"); }
+    bool cpuHasAvx2()  { return __builtin_cpu_supports("avx2"); }
+#endif
+#endif
+
+    // @brief Picks the widest kernel the CPU supports; nullptr means the scalar path.
+    BatchKernel selectBatchKernel() {
+#if defined(PGS_PERLIN_X86_KERNELS)
+        if (cpuHasAvx2())
+            return PGS::NodeGraph::Utils::PerlinKernels::evaluateAvx2;
+        if (cpuHasSse41())
+            return PGS::NodeGraph::Utils::PerlinKernels::evaluateSse41;
+#endif
+        return nullptr;
+    }
+}
+
+PGS::NodeGraph::Utils::PerlinNoise2D::PerlinNoise2D(const unsigned int seed)
+    : permutation(getPermutationTable(seed))
+{}
+
+std::shared_ptr<const PGS::NodeGraph::Utils::PerlinNoise2D::PermutationTable>
+PGS::NodeGraph::Utils::PerlinNoise2D::getPermutationTable(const unsigned int seed) {
+    // Weak references: a table lives as long as some generator uses it, so dragging the seed doesn't pile up tables
+    static std::mutex mutex;
+    static std::unordered_map<unsigned int, std::weak_ptr<const PermutationTable>> cache;
+
+    std::lock_guard lock(mutex);
+
+    if (const auto it = cache.find(seed); it != cache.end()) {
+        if (auto table = it->second.lock())
+            return table;
+    }
+
+    std::erase_if(cache, [](const auto& entry) { return entry.second.expired(); });
+
+    auto table = std::make_shared<PermutationTable>();
+    const auto firstHalf = table->begin() + 256;
+
+    std::iota(table->begin(), firstHalf, 0);
 
     std::default_random_engine engine(seed);
-    std::shuffle(permutation.begin(), permutation.end(), engine);
+    std::shuffle(table->begin(), firstHalf, engine);
+
+    std::copy(table->begin(), firstHalf, firstHalf);
 
-    permutation.insert(permutation.end(), permutation.begin(), permutation.end());
+    cache[seed] = table;
+    return table;
 }
 
 float PGS::NodeGraph::Utils::PerlinNoise2D::getValue(const sf::Vector2f& pos) const {
@@ -36,6 +108,21 @@ float PGS::NodeGraph::Utils::PerlinNoise2D::getValue(const sf::Vector2f& pos) co
     return lerp(x1, x2, u);
 }
 
+void PGS::NodeGraph::Utils::PerlinNoise2D::getValues(
+    const float* xs, const float* ys, float* values, const std::size_t count) const
+{
+    static const BatchKernel kernel = selectBatchKernel();
+
+    if (kernel) {
+        kernel(permutation->data(), xs, ys, values, count);
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        values[i] = getValue({xs[i], ys[i]});
+    }
+}
+
 float PGS::NodeGraph::Utils::PerlinNoise2D::fade(const float t) {
     return t * t * t * (t * (t * 6 - 15) + 10);
 }
@@ -60,5 +147,6 @@ float PGS::NodeGraph::Utils::PerlinNoise2D::grad(const int hash, const float x,
 }
 
 int PGS::NodeGraph::Utils::PerlinNoise2D::hash(const int x, const int y) const {
-    return permutation[permutation[x & 255] + (y & 255)];
+    const PermutationTable& table = *permutation;
+    return table[table[x & 255] + (y & 255)];
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "PGS/node_graph/utils/perlin_noise_2d_kernels.h"
+
+#if defined(PGS_PERLIN_X86_KERNELS)
+
+#include <immintrin.h>
+#include <cstring>
+
+// Compiled with AVX2 enabled but without FMA (see CMakeLists.txt): fused multiply-adds would round
+// differently from PerlinNoise2D::getValue, and the batch results must match it bit for bit.
+namespace
+{
+    constexpr int LANES = 8;
+
+    __m256 fade(const __m256 t) {
+        const __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))),
+                                           _mm256_set1_ps(10.0f));
+        return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+    }
+
+    __m256 lerp(const __m256 a, const __m256 b, const __m256 t) {
+        return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+    }
+
+    // Branchless form of the `hash & 7` switch:
+    // 0-3 -> (+-x) + (+-y) with the signs taken from bits 0 and 1, 4-7 -> +-(bit 1 ? y : x)
+    __m256 grad(const __m256i hash, const __m256 x, const __m256 y) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256 sign = _mm256_set1_ps(-0.0f);
+
+        const __m256 bit0 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(1)), zero));
+        const __m256 bit1 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(2)), zero));
+        const __m256 bit2 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(4)), zero));
+
+        const __m256 signX = _mm256_and_ps(bit0, sign);
+        const __m256 sum = _mm256_add_ps(_mm256_xor_ps(x, signX), _mm256_xor_ps(y, _mm256_and_ps(bit1, sign)));
+        const __m256 single = _mm256_xor_ps(_mm256_blendv_ps(x, y, bit1), signX);
+
+        return _mm256_blendv_ps(sum, single, bit2);
+    }
+
+    __m256i hash(const int* table, const __m256i x, const __m256i y) {
+        const __m256i row = _mm256_i32gather_epi32(table, x, 4);
+        return _mm256_i32gather_epi32(table, _mm256_add_epi32(row, y), 4);
+    }
+
+    __m256 evaluate(const int* table, const __m256 px, const __m256 py) {
+        const __m256i mask = _mm256_set1_epi32(255);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 oneF = _mm256_set1_ps(1.0f);
+
+        const __m256 floorX = _mm256_floor_ps(px);
+        const __m256 floorY = _mm256_floor_ps(py);
+
+        const __m256i xi = _mm256_and_si256(_mm256_cvttps_epi32(floorX), mask);
+        const __m256i yi = _mm256_and_si256(_mm256_cvttps_epi32(floorY), mask);
+        const __m256i xi1 = _mm256_and_si256(_mm256_add_epi32(xi, one), mask);
+        const __m256i yi1 = _mm256_and_si256(_mm256_add_epi32(yi, one), mask);
+
+        const __m256 xf = _mm256_sub_ps(px, floorX);
+        const __m256 yf = _mm256_sub_ps(py, floorY);
+        const __m256 xf1 = _mm256_sub_ps(xf, oneF);
+        const __m256 yf1 = _mm256_sub_ps(yf, oneF);
+
+        const __m256 u = fade(xf);
+        const __m256 v = fade(yf);
+
+        const __m256 x1 = lerp(grad(hash(table, xi, yi), xf, yf), grad(hash(table, xi, yi1), xf, yf1), v);
+        const __m256 x2 = lerp(grad(hash(table, xi1, yi), xf1, yf), grad(hash(table, xi1, yi1), xf1, yf1), v);
+
+        return lerp(x1, x2, u);
+    }
+}
+
+void PGS::NodeGraph::Utils::PerlinKernels::evaluateAvx2(
+    const int* table, const float* xs, const float* ys, float* values, const std::size_t count)
+{
+    std::size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        _mm256_storeu_ps(values + i, evaluate(table, _mm256_loadu_ps(xs + i), _mm256_loadu_ps(ys + i)));
+    }
+
+    // Tail: pad to a full vector instead of keeping a scalar copy of the kernel.
+    // Plain memcpy on purpose: inline templates instantiated in this file could be merged
+    // by the linker with the copies used on CPUs without this instruction set
+    if (i < count) {
+        const std::size_t rest = count - i;
+        float tailX[LANES] = {};
+        float tailY[LANES] = {};
+        float tailValues[LANES];
+
+        std::memcpy(tailX, xs + i, rest * sizeof(float));
+        std::memcpy(tailY, ys + i, rest * sizeof(float));
+        _mm256_storeu_ps(tailValues, evaluate(table, _mm256_loadu_ps(tailX), _mm256_loadu_ps(tailY)));
+        std::memcpy(values + i, tailValues, rest * sizeof(float));
+    }
+}
+
+#endif
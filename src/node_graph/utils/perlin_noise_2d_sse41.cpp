@@ -0,0 +1,104 @@
+#include "PGS/node_graph/utils/perlin_noise_2d_kernels.h"
+
+#if defined(PGS_PERLIN_X86_KERNELS)
+
+#include <smmintrin.h>
+#include <cstring>
+
+// Compiled with SSE4.1 enabled (see CMakeLists.txt). Mirrors PerlinNoise2D::getValue operation
+// for operation, so the results are bit-identical to the scalar path.
+namespace
+{
+    constexpr int LANES = 4;
+
+    __m128 fade(const __m128 t) {
+        const __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))),
+                                        _mm_set1_ps(10.0f));
+        return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+    }
+
+    __m128 lerp(const __m128 a, const __m128 b, const __m128 t) {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+    }
+
+    // Branchless form of the `hash & 7` switch:
+    // 0-3 -> (+-x) + (+-y) with the signs taken from bits 0 and 1, 4-7 -> +-(bit 1 ? y : x)
+    __m128 grad(const __m128i hash, const __m128 x, const __m128 y) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 sign = _mm_set1_ps(-0.0f);
+
+        const __m128 bit0 = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_and_si128(hash, _mm_set1_epi32(1)), zero));
+        const __m128 bit1 = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_and_si128(hash, _mm_set1_epi32(2)), zero));
+        const __m128 bit2 = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_and_si128(hash, _mm_set1_epi32(4)), zero));
+
+        const __m128 signX = _mm_and_ps(bit0, sign);
+        const __m128 sum = _mm_add_ps(_mm_xor_ps(x, signX), _mm_xor_ps(y, _mm_and_ps(bit1, sign)));
+        const __m128 single = _mm_xor_ps(_mm_blendv_ps(x, y, bit1), signX);
+
+        return _mm_blendv_ps(sum, single, bit2);
+    }
+
+    // No gather before AVX2, so the table lookups are done lane by lane
+    __m128i lookup(const int* table, const __m128i indices) {
+        alignas(16) int lanes[LANES];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), indices);
+        return _mm_setr_epi32(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]);
+    }
+
+    __m128i hash(const int* table, const __m128i x, const __m128i y) {
+        return lookup(table, _mm_add_epi32(lookup(table, x), y));
+    }
+
+    __m128 evaluate(const int* table, const __m128 px, const __m128 py) {
+        const __m128i mask = _mm_set1_epi32(255);
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128 oneF = _mm_set1_ps(1.0f);
+
+        const __m128 floorX = _mm_floor_ps(px);
+        const __m128 floorY = _mm_floor_ps(py);
+
+        const __m128i xi = _mm_and_si128(_mm_cvttps_epi32(floorX), mask);
+        const __m128i yi = _mm_and_si128(_mm_cvttps_epi32(floorY), mask);
+        const __m128i xi1 = _mm_and_si128(_mm_add_epi32(xi, one), mask);
+        const __m128i yi1 = _mm_and_si128(_mm_add_epi32(yi, one), mask);
+
+        const __m128 xf = _mm_sub_ps(px, floorX);
+        const __m128 yf = _mm_sub_ps(py, floorY);
+        const __m128 xf1 = _mm_sub_ps(xf, oneF);
+        const __m128 yf1 = _mm_sub_ps(yf, oneF);
+
+        const __m128 u = fade(xf);
+        const __m128 v = fade(yf);
+
+        const __m128 x1 = lerp(grad(hash(table, xi, yi), xf, yf), grad(hash(table, xi, yi1), xf, yf1), v);
+        const __m128 x2 = lerp(grad(hash(table, xi1, yi), xf1, yf), grad(hash(table, xi1, yi1), xf1, yf1), v);
+
+        return lerp(x1, x2, u);
+    }
+}
+
+void PGS::NodeGraph::Utils::PerlinKernels::evaluateSse41(
+    const int* table, const float* xs, const float* ys, float* values, const std::size_t count)
+{
+    std::size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        _mm_storeu_ps(values + i, evaluate(table, _mm_loadu_ps(xs + i), _mm_loadu_ps(ys + i)));
+    }
+
+    // Tail: pad to a full vector instead of keeping a scalar copy of the kernel.
+    // Plain memcpy on purpose: inline templates instantiated in this file could be merged
+    // by the linker with the copies used on CPUs without this instruction set
+    if (i < count) {
+        const std::size_t rest = count - i;
+        float tailX[LANES] = {};
+        float tailY[LANES] = {};
+        float tailValues[LANES];
+
+        std::memcpy(tailX, xs + i, rest * sizeof(float));
+        std::memcpy(tailY, ys + i, rest * sizeof(float));
+        _mm_storeu_ps(tailValues, evaluate(table, _mm_loadu_ps(tailX), _mm_loadu_ps(tailY)));
+        std::memcpy(values + i, tailValues, rest * sizeof(float));
+    }
+}
+
+#endif
@@ -0,0 +1,206 @@
+#include "PGS/node_graph/utils/thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    // Index of the queue owned by the current thread; workers push nested tasks to their own queue
+    constexpr size_t NO_QUEUE = static_cast<size_t>(-1);
+    thread_local size_t currentQueue = NO_QUEUE;
+    thread_local const void* currentPool = nullptr;
+}
+
+PGS::NodeGraph::Utils::ThreadPool::ThreadPool(const unsigned int threadCount)
+{
+    const unsigned int workerCount = std::max(threadCount, 1u) - 1;
+
+    // One queue per worker plus a shared one for tasks pushed from outside the pool
+    for (unsigned int i = 0; i < workerCount + 1; ++i)
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+
+    for (unsigned int i = 0; i < workerCount; ++i)
+        m_workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+PGS::NodeGraph::Utils::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_sleepCondition.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+unsigned int PGS::NodeGraph::Utils::ThreadPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(m_workers.size()) + 1;
+}
+
+void PGS::NodeGraph::Utils::ThreadPool::run(TaskGroup& group, std::function<void()> task)
+{
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_workers.empty())
+    {
+        Task inlineTask{std::move(task), &group};
+        execute(inlineTask);
+        return;
+    }
+
+    const size_t queueIndex = (currentPool == this)
+        ? currentQueue
+        : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    {
+        auto& queue = *m_queues[queueIndex];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back({std::move(task), &group});
+    }
+
+    m_queuedTasks.fetch_add(1, std::memory_order_release);
+    notifyAll();
+}
+
+void PGS::NodeGraph::Utils::ThreadPool::wait(TaskGroup& group)
+{
+    const size_t preferredQueue = (currentPool == this) ? currentQueue : m_queues.size() - 1;
+
+    while (group.m_pending.load(std::memory_order_acquire) != 0)
+    {
+        if (tryRunTask(preferredQueue))
+            continue;
+
+        std::unique_lock lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [&]
+        {
+            return group.m_pending.load(std::memory_order_acquire) == 0 ||
+                   m_queuedTasks.load(std::memory_order_acquire) != 0;
+        });
+    }
+
+    std::lock_guard lock(group.m_errorMutex);
+    if (group.m_error)
+        std::rethrow_exception(std::exchange(group.m_error, nullptr));
+}
+
+void PGS::NodeGraph::Utils::ThreadPool::parallelFor(const size_t begin, const size_t end, size_t grainSize,
+                                                   const std::function<void(size_t, size_t)>& function)
+{
+    if (begin >= end)
+        return;
+
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    // A few chunks per thread keep the load balanced when chunks have an uneven cost
+    const size_t total = end - begin;
+    const size_t chunkCount = std::clamp<size_t>(total / grainSize, 1, static_cast<size_t>(getThreadCount()) * 4);
+
+    if (chunkCount == 1)
+    {
+        function(begin, end);
+        return;
+    }
+
+    TaskGroup group;
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        const size_t chunkBegin = begin + total * chunk / chunkCount;
+        const size_t chunkEnd = begin + total * (chunk + 1) / chunkCount;
+
+        run(group, [&function, chunkBegin, chunkEnd] { function(chunkBegin, chunkEnd); });
+    }
+
+    wait(group);
+}
+
+// -- Private Methods --
+void PGS::NodeGraph::Utils::ThreadPool::workerLoop(const size_t index)
+{
+    currentPool = this;
+    currentQueue = index;
+
+    while (true)
+    {
+        if (tryRunTask(index))
+            continue;
+
+        std::unique_lock lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [&]
+        {
+            return m_stopping || m_queuedTasks.load(std::memory_order_acquire) != 0;
+        });
+
+        if (m_stopping)
+            return;
+    }
+}
+
+bool PGS::NodeGraph::Utils::ThreadPool::tryRunTask(const size_t preferredQueue)
+{
+    if (m_queuedTasks.load(std::memory_order_acquire) == 0)
+        return false;
+
+    Task task{};
+    bool found = false;
+
+    // Own queue first (newest task), then steal the oldest task from the others
+    {
+        auto& queue = *m_queues[preferredQueue];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    for (size_t offset = 1; !found && offset < m_queues.size(); ++offset)
+    {
+        auto& queue = *m_queues[(preferredQueue + offset) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found)
+        return false;
+
+    m_queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+    execute(task);
+    return true;
+}
+
+void PGS::NodeGraph::Utils::ThreadPool::execute(Task& task)
+{
+    try
+    {
+        task.function();
+    }
+    catch (...)
+    {
+        std::lock_guard lock(task.group->m_errorMutex);
+        if (!task.group->m_error)
+            task.group->m_error = std::current_exception();
+    }
+
+    if (task.group->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        notifyAll();
+}
+
+void PGS::NodeGraph::Utils::ThreadPool::notifyAll()
+{
+    // Taking the lock orders the state change before a waiter re-checks its predicate
+    {
+        std::lock_guard lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_all();
+}